@@ -931,6 +931,65 @@ Amr::writeSmallPlotFile ()
     BL_PROFILE_REGION_STOP("Amr::writeSmallPlotFile()");
 }
 
+void
+Amr::writeQuickLook ()
+{
+    if ( ! Plot_Files_Output()) {
+        return;
+    }
+
+    BL_PROFILE("Amr::writeQuickLook()");
+
+    if (first_smallplotfile) {
+        first_smallplotfile = false;
+        amr_level[0]->setSmallPlotVariables();
+    }
+
+    Vector<std::string> varnames;
+    for (auto const& name : stateSmallPlotVars()) {
+        varnames.push_back(name);
+    }
+    for (auto const& name : deriveSmallPlotVars()) {
+        const DeriveRec* rec = AmrLevel::get_derive_lst().get(name);
+        for (int i = 0; i < rec->numDerive(); ++i) {
+            varnames.push_back(rec->variableName(i));
+        }
+    }
+
+    if (varnames.empty()) {
+        return;
+    }
+
+    const int ncomp = static_cast<int>(varnames.size());
+    Vector<MultiFab> mf(finest_level+1);
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        mf[lev].define(boxArray(lev), DistributionMap(lev), ncomp, 0);
+        int cnt = 0;
+        for (auto const& name : stateSmallPlotVars()) {
+            int typ, comp;
+            AmrLevel::isStateVariable(name, typ, comp);
+            MultiFab::Copy(mf[lev], amr_level[lev]->get_new_data(typ), comp, cnt, 1, 0);
+            ++cnt;
+        }
+        for (auto const& name : deriveSmallPlotVars()) {
+            amr_level[lev]->derive(name, cumtime, mf[lev], cnt);
+            cnt += AmrLevel::get_derive_lst().get(name)->numDerive();
+        }
+    }
+
+    const std::string& qlkfile = amrex::Concatenate(quicklook->fileRoot(),
+                                                    level_steps[0],
+                                                    file_name_digits);
+
+    if (verbose > 0) {
+        amrex::Print() << "QUICKLOOK: file = " << qlkfile << '\n';
+    }
+
+    quicklook->write(qlkfile, amrex::GetVecOfConstPtrs(mf), varnames, Geom(),
+                     refRatio(), cumtime, level_steps[0]);
+}
+
 void
 Amr::writePlotFileDoit (std::string const& pltfile, bool regular)
 {
@@ -2317,6 +2376,11 @@ Amr::coarseTimeStep (Real stop_time)
         writeSmallPlotFile();
     }
 
+    if (quicklook->writeNow(level_steps[0]))
+    {
+        writeQuickLook();
+    }
+
     updateInSitu();
 
     bUserStopRequest = to_stop;
@@ -3240,6 +3304,8 @@ Amr::initPltAndChk ()
             amrex::Warning("Warning: both amr.small_plot_int and amr.small_plot_per are > 0.");
     }
 
+    quicklook = std::make_unique<QuickLook>("amr.quicklook");
+
     write_plotfile_with_checkpoint = 1;
     pp.queryAdd("write_plotfile_with_checkpoint",write_plotfile_with_checkpoint);
 
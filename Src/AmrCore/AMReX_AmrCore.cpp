@@ -107,7 +107,13 @@ AmrCore::regrid (int lbase, Real time, bool)
                 DistributionMapping level_dmap = dmap[lev];
                 if (ba_changed) {
                     level_grids = new_grids[lev];
-                    level_dmap = DistributionMapping(level_grids);
+                    if (incremental_regrid) {
+                        level_dmap = DistributionMapping::makeIncremental(level_grids,
+                                                                          grids[lev],
+                                                                          dmap[lev]);
+                    } else {
+                        level_dmap = DistributionMapping(level_grids);
+                    }
                 }
                 const auto old_num_setdm = num_setdm;
                 RemakeLevel(lev, time, level_grids, level_dmap);
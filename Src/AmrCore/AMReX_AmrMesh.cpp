@@ -5,6 +5,14 @@
 #include <AMReX_ParmParse.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Print.H>
+#include <AMReX_StartupCache.H>
+#include <AMReX_iMultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
 
 namespace amrex {
 
@@ -50,6 +58,9 @@ AmrMesh::AmrMesh (Geometry const& level_0_geom, AmrInfo const& amr_info)
     n_error_buf.resize    (nlev, amr_info.n_error_buf.empty()
                            ? def_amr_info.n_error_buf.back()
                            :     amr_info.n_error_buf.back());
+    fixed_block_regrid.resize(nlev, amr_info.fixed_block_regrid.empty()
+                              ? def_amr_info.fixed_block_regrid.back()
+                              :     amr_info.fixed_block_regrid.back());
 
     dmap.resize(nlev);
     grids.resize(nlev);
@@ -84,6 +95,7 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
     blocking_factor.resize(nlev);
     max_grid_size.resize(nlev);
     n_error_buf.resize(nlev);
+    fixed_block_regrid.resize(nlev);
 
     geom.resize(nlev);
     dmap.resize(nlev);
@@ -105,6 +117,7 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
 
     pp.queryAdd("n_proper",n_proper);
     pp.queryAdd("grid_eff",grid_eff);
+    pp.queryAdd("use_distributed_chop",use_distributed_chop);
     int cnt = pp.countval("n_error_buf");
     if (cnt > 0) {
         Vector<int> neb;
@@ -164,6 +177,21 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in,
     }
 #endif
 
+    cnt = pp.countval("fixed_block_regrid");
+    if (cnt > 0) {
+        Vector<int> fbr;
+        pp.getarr("fixed_block_regrid",fbr);
+        int n = std::min(cnt, max_level+1);
+        for (int i = 0; i < n; ++i) {
+            fixed_block_regrid[i] = fbr[i];
+        }
+        for (int i = n; i <= max_level; ++i) {
+            fixed_block_regrid[i] = fbr[cnt-1];
+        }
+    }
+    pp.queryAdd("fixed_block_eff",fixed_block_eff);
+    pp.queryAdd("incremental_regrid",incremental_regrid);
+
     // Read in the refinement ratio IntVects as integer AMREX_SPACEDIM-tuples.
     if (max_level > 0)
     {
@@ -490,6 +518,149 @@ AmrMesh::MakeBaseGrids () const
 }
 
 
+namespace {
+
+//
+// Moves the tagged blocks to tiles of size tile, aligned to multiples of
+// tile and each owned by one process, and returns the local ones sorted by
+// tile.  Ghost tags outside the tiles covering the valid boxes cannot be
+// in the proper nesting domain and are dropped.
+//
+void
+CollateTilesOfBlocks (const TagBoxArray& tags, const IntVect& tile,
+                      Gpu::PinnedVector<IntVect>& tagvec)
+{
+    BL_PROFILE("AmrMesh::CollateTilesOfBlocks()");
+
+    BoxList tiles(tags.boxArray());
+    tiles.coarsen(tile);
+    BoxArray tba(std::move(tiles));
+    tba.removeOverlap();
+    tiles = tba.boxList();
+    tiles.refine(tile);
+    tba = BoxArray(std::move(tiles));
+    tba.maxSize(tile);
+
+    TagBoxArray ttags(tba, DistributionMapping(tba), 0);
+
+    if (Gpu::inLaunchRegion())
+    {
+        // There is not atomicAdd for char.  So we have to use int.
+        iMultiFab itag = amrex::cast<iMultiFab>(tags);
+        iMultiFab tmp(tba, ttags.DistributionMap(), 1, 0);
+        tmp.setVal(0);
+        tmp.ParallelAdd(itag, 0, 0, 1, tags.nGrowVect(), IntVect(0), Periodicity::NonPeriodic());
+        for (MFIter mfi(tmp); mfi.isValid(); ++mfi) {
+            Array4<TagBox::TagType> const& tag = ttags.array(mfi);
+            Array4<int const> const& tmptag = tmp.const_array(mfi);
+            amrex::ParallelFor(mfi.validbox(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                tag(i,j,k) = (tmptag(i,j,k) != 0) ? TagBox::SET : TagBox::CLEAR;
+            });
+        }
+    }
+    else
+    {
+        ttags.ParallelAdd(tags, 0, 0, 1, tags.nGrowVect(), IntVect(0), Periodicity::NonPeriodic());
+    }
+
+    ttags.local_collate(tagvec);
+
+    std::sort(tagvec.begin(), tagvec.end(),
+              [&] (const IntVect& a, const IntVect& b) -> bool
+              {
+                  const IntVect ta = amrex::coarsen(a,tile);
+                  const IntVect tb = amrex::coarsen(b,tile);
+                  return (ta == tb) ? a < b : ta < tb;
+              });
+}
+
+//
+// Covers the tagged blocks in each tile with boxes.  The bounding box of
+// the blocks in a tile is used if its efficiency is at least eff and it is
+// properly nested, otherwise the blocks are merged greedily into boxes
+// that contain tagged blocks only.  The boxes are returned on all
+// processes.  Note that domba is modified.
+//
+BoxList
+FixedBlockBoxes (const Gpu::PinnedVector<IntVect>& tagvec, const IntVect& tile,
+                 Real eff, BoxArray& domba)
+{
+    BL_PROFILE("AmrMesh::FixedBlockBoxes()");
+
+    domba.removeOverlap();
+
+    Vector<Box> bxs;
+    Vector<char> mask;
+
+    const Long ntags = tagvec.size();
+    for (Long ib = 0; ib < ntags; )
+    {
+        const IntVect t = amrex::coarsen(tagvec[ib],tile);
+        Long ie = ib;
+        IntVect lo = tagvec[ib], hi = lo;
+        while (ie < ntags && amrex::coarsen(tagvec[ie],tile) == t) {
+            lo.min(tagvec[ie]);
+            hi.max(tagvec[ie]);
+            ++ie;
+        }
+        const Box bbox(lo,hi);
+        const Long nblocks = ie - ib;
+
+        bool assume_disjoint_ba = true;
+        if (Real(nblocks/bbox.d_numPts()) >= eff &&
+            domba.contains(bbox,assume_disjoint_ba))
+        {
+            bxs.push_back(bbox);
+        }
+        else
+        {
+            mask.assign(bbox.numPts(), 0);
+            for (Long i = ib; i < ie; ++i) {
+                mask[bbox.index(tagvec[i])] = 1;
+            }
+            auto all_tagged = [&] (const Box& b) -> bool
+            {
+                for (IntVect iv = b.smallEnd(); iv <= b.bigEnd(); b.next(iv)) {
+                    if (!mask[bbox.index(iv)]) return false;
+                }
+                return true;
+            };
+            for (IntVect iv = bbox.smallEnd(); iv <= bbox.bigEnd(); bbox.next(iv))
+            {
+                if (!mask[bbox.index(iv)]) continue;
+                //
+                // Grow the box direction by direction as long as the next
+                // slab is fully tagged.
+                //
+                Box b(iv,iv);
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    while (b.bigEnd(idim) < bbox.bigEnd(idim)) {
+                        Box slab = b;
+                        slab.setRange(idim, b.bigEnd(idim)+1);
+                        if (!all_tagged(slab)) break;
+                        b.setBig(idim, b.bigEnd(idim)+1);
+                    }
+                }
+                for (IntVect jv = b.smallEnd(); jv <= b.bigEnd(); b.next(jv)) {
+                    mask[bbox.index(jv)] = 0;
+                }
+                bxs.push_back(b);
+            }
+        }
+        ib = ie;
+    }
+
+    domba.clear();
+
+    amrex::AllGatherBoxes(bxs);
+
+    return BoxList(std::move(bxs));
+}
+
+}
+
 void
 AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>& new_grids)
 {
@@ -589,6 +760,17 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         // new levels projected down to this level.
         //
         IntVect ngt = n_error_buf[levc];
+
+        Real sweep_time = 0.0;
+        auto const& sweep_vel = TagSweepVelocity(levc, time, sweep_time);
+        const bool do_sweep = sweep_vel[0] != nullptr && sweep_time > 0.0;
+        if (do_sweep) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                Real dmax = sweep_vel[idim]->norminf(0, 0) * sweep_time * geom[levc].InvCellSize(idim);
+                ngt[idim] = std::max(ngt[idim], n_error_buf[levc][idim] + static_cast<int>(std::ceil(dmax)));
+            }
+        }
+
         BoxArray ba_proj;
         if (levf < new_finest)
         {
@@ -621,6 +803,10 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         //
         tags.buffer(n_error_buf[levc]);
 
+        if (do_sweep) {
+            tags.sweep(sweep_vel, sweep_time, geom[levc]);
+        }
+
         if (useFixedCoarseGrids())
         {
             if (levc>=useFixedUpToLevel())
@@ -675,10 +861,29 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         // Create initial cluster containing all tagged points.
         //
         Gpu::PinnedVector<IntVect> tagvec;
-        tags.collate(tagvec);
+        Long ntags;
+        const bool fixed_block = fixed_block_regrid[levc];
+        IntVect tile(1);
+        if (fixed_block) {
+            //
+            // A tile of blocks is at most max_grid_size at level levf.
+            //
+            tile = max_grid_size[levf] / blocking_factor[levf];
+            tile.max(IntVect(1));
+            CollateTilesOfBlocks(tags, tile, tagvec);
+            ntags = tagvec.size();
+            ParallelDescriptor::ReduceLongSum(ntags);
+        } else if (use_distributed_chop) {
+            tags.local_collate(tagvec);
+            ntags = tagvec.size();
+            ParallelDescriptor::ReduceLongSum(ntags);
+        } else {
+            tags.collate(tagvec);
+            ntags = tagvec.size();
+        }
         tags.clear();
 
-        if (tagvec.size() > 0)
+        if (ntags > 0)
         {
             //
             // Created new level, now generate efficient grids.
@@ -689,7 +894,19 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 
             if (levf > useFixedUpToLevel()) {
                 BoxList new_bx;
-                if (ParallelDescriptor::IOProcessor()) {
+                if (fixed_block) {
+                    BL_PROFILE("AmrMesh-fixed-block");
+                    new_bx = FixedBlockBoxes(tagvec, tile, fixed_block_eff, p_n_ba[levc]);
+                } else if (use_distributed_chop) {
+                    BL_PROFILE("AmrMesh-cluster");
+                    //
+                    // Every process clusters its own tags; the result is
+                    // known to all processes.
+                    //
+                    new_bx = ClusterList::distributedChop(tagvec.data(), tagvec.size(),
+                                                          grid_eff, p_n_ba[levc],
+                                                          use_new_chop);
+                } else if (ParallelDescriptor::IOProcessor()) {
                     BL_PROFILE("AmrMesh-cluster");
                     //
                     // Construct initial cluster.
@@ -701,11 +918,14 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
                         clist.chop(grid_eff);
                     }
                     clist.intersect(p_n_ba[levc]);
+                    clist.boxList(new_bx);
+                }
+                const bool everywhere = fixed_block || use_distributed_chop;
+                if (everywhere || ParallelDescriptor::IOProcessor()) {
                     //
                     // Efficient properly nested Clusters have been constructed
                     // now generate list of grids at level levf.
                     //
-                    clist.boxList(new_bx);
                     new_bx.refine(bf_lev[levc]);
                     new_bx.simplify();
 
@@ -714,7 +934,9 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
                         new_bx.intersect(Geom(levc).Domain());
                     }
                 }
-                new_bx.Bcast();  // Broadcast the new BoxList to other processes
+                if (!everywhere) {
+                    new_bx.Bcast();  // Broadcast the new BoxList to other processes
+                }
 
                 //
                 // Refine up to levf.
@@ -767,6 +989,44 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
 void
 AmrMesh::MakeNewGrids (Real time)
 {
+    std::string cache_key;
+    if (StartupCache::gridsEnabled())
+    {
+        std::ostringstream os;
+        os << std::setprecision(17)
+           << "nprocs = " << ParallelDescriptor::NProcs() << "\n"
+           << "time = " << time << "\n"
+           << "domain = " << Geom(0).Domain() << "\n"
+           << "prob_domain = " << Geom(0).ProbDomain() << "\n"
+           << "coord = " << Geom(0).Coord() << "\n"
+           << "is_periodic =" AMREX_D_TERM(<< " " << Geom(0).isPeriodic(0),
+                                           << " " << Geom(0).isPeriodic(1),
+                                           << " " << Geom(0).isPeriodic(2)) << "\n"
+           << *this;
+        cache_key = StartupCache::makeKey("grids", {}, os.str());
+        if (StartupCache::exists(cache_key)) {
+            // The initial hierarchy is taken from the cache without tagging.
+            Vector<BoxArray> new_grids;
+            Vector<DistributionMapping> new_dmap;
+            StartupCache::readGrids(StartupCache::entryPath(cache_key), new_grids, new_dmap);
+            for (int lev = 0; lev < new_grids.size(); ++lev) {
+                finest_level = lev;
+                const auto old_num_setdm = num_setdm;
+                const auto old_num_setba = num_setba;
+
+                MakeNewLevelFromScratch(lev, time, new_grids[lev], new_dmap[lev]);
+
+                if (old_num_setba == num_setba) {
+                    SetBoxArray(lev, new_grids[lev]);
+                }
+                if (old_num_setdm == num_setdm) {
+                    SetDistributionMap(lev, new_dmap[lev]);
+                }
+            }
+            return;
+        }
+    }
+
     // define coarse level BoxArray and DistributionMap
     {
         finest_level = 0;
@@ -846,6 +1106,14 @@ AmrMesh::MakeNewGrids (Real time)
             }
         }
     }
+
+    if (!cache_key.empty()) {
+        std::string dir = StartupCache::beginWrite(cache_key);
+        StartupCache::writeGrids(dir,
+                                 Vector<BoxArray>(grids.begin(), grids.begin()+finest_level+1),
+                                 Vector<DistributionMapping>(dmap.begin(), dmap.begin()+finest_level+1));
+        StartupCache::commit(cache_key, dir);
+    }
 }
 
 void
@@ -1037,6 +1305,12 @@ std::ostream& operator<< (std::ostream& os, AmrMesh const& amr_mesh)
     os << "  refine_grid_layout_dims = " << amr_mesh.refine_grid_layout_dims << "\n";
     os << "  check_input = " << amr_mesh.check_input  << "\n";
     os << "  use_new_chop = " << amr_mesh.use_new_chop << "\n";
+    os << "  use_distributed_chop = " << amr_mesh.use_distributed_chop << "\n";
+    os << "  fixed_block_regrid =";
+    for (int lev = 0; lev < amr_mesh.max_level; ++lev) os << " " << amr_mesh.fixed_block_regrid[lev];
+    os << "\n";
+    os << "  fixed_block_eff = " << amr_mesh.fixed_block_eff << "\n";
+    os << "  incremental_regrid = " << amr_mesh.incremental_regrid << "\n";
     os << "  iterate_on_new_grids = " << amr_mesh.iterate_on_new_grids << "\n";
     return os;
 }
@@ -5,9 +5,11 @@
 #include <AMReX_Vector.H>
 #include <AMReX_Array.H>
 #include <AMReX_BLProfiler.H>
+#include <AMReX_ParallelDescriptor.H>
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace amrex {
 
@@ -604,4 +606,333 @@ ClusterList::intersect (BoxArray& domba)
     domba.clear();
 }
 
+namespace {
+//
+// A region of the cluster tree in ClusterList::distributedChop().  The local points
+// of the region are pts[begin,end) and they all lie in box.
+//
+struct DCRegion
+{
+    Box  box;
+    Long begin;
+    Long end;
+    //! Index of the parent if this is a half of a trial cut of new_chop.
+    int  trial;
+};
+
+//
+// A region after its histograms have been summed over all processes.
+//
+struct DCCluster
+{
+    Box  box;            // minimal box containing the tagged points
+    Long count = 0;
+    Real eff   = 0;
+    Long begin = 0;
+    Long end   = 0;
+    int  dir   = -1;     // direction of the trial cut
+    Array<Vector<int>,AMREX_SPACEDIM> hist;  // histograms over box
+};
+
+//
+// Chooses the cut as in Cluster::chop().  Direction invalid_dir is not
+// considered as in the second try of Cluster::new_chop().  Returns the
+// number of points below the cut.
+//
+Long
+DCFindCut (const DCCluster& c, int invalid_dir, int& dir, IntVect& cut)
+{
+    const int* lo = c.box.loVect();
+    const int* hi = c.box.hiVect();
+
+    CutStatus mincut = InvalidCut;
+    CutStatus status[AMREX_SPACEDIM];
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        if (n != invalid_dir)
+        {
+            cut[n] = FindCut(c.hist[n].data(), lo[n], hi[n], status[n]);
+            if (status[n] < mincut)
+            {
+                mincut = status[n];
+            }
+        }
+        else
+        {
+            cut[n] = lo[n];
+            status[n] = InvalidCut;
+        }
+    }
+
+    dir = -1;
+    if (mincut == InvalidCut) return 0;
+
+    for (int n = 0, minlen = -1; n < AMREX_SPACEDIM; n++)
+    {
+        if (n != invalid_dir && status[n] == mincut)
+        {
+            int mincutlen = std::min(cut[n]-lo[n],hi[n]-cut[n]);
+            if (mincutlen >= minlen)
+            {
+                dir = n;
+                minlen = mincutlen;
+            }
+        }
+    }
+    BL_ASSERT(dir >= 0 && dir < AMREX_SPACEDIM);
+
+    Long nlo = 0;
+    for (int i = lo[dir]; i < cut[dir]; i++) {
+        nlo += c.hist[dir][i-lo[dir]];
+    }
+    return nlo;
+}
+}
+
+BoxList
+ClusterList::distributedChop (IntVect* pts, Long len, Real eff,
+                              BoxArray& domba, bool use_new_chop)
+{
+    BL_PROFILE("ClusterList::distributedChop()");
+
+    constexpr int imax = std::numeric_limits<int>::max();
+    //
+    // The root of the tree is the bounding box of all points.  The upper
+    // bounds are negated so that one min reduction does for both.
+    //
+    Vector<int> bnd(2*AMREX_SPACEDIM, imax);
+    for (Long i = 0; i < len; i++)
+    {
+        for (int n = 0; n < AMREX_SPACEDIM; n++)
+        {
+            bnd[n]                = std::min(bnd[n], pts[i][n]);
+            bnd[n+AMREX_SPACEDIM] = std::min(bnd[n+AMREX_SPACEDIM], -pts[i][n]);
+        }
+    }
+    ParallelDescriptor::ReduceIntMin(bnd.data(), bnd.size());
+
+    if (bnd[0] > -bnd[AMREX_SPACEDIM]) return BoxList();
+
+    IntVect lo, hi;
+    for (int n = 0; n < AMREX_SPACEDIM; n++)
+    {
+        lo[n] = bnd[n];
+        hi[n] = -bnd[n+AMREX_SPACEDIM];
+    }
+
+    Vector<DCRegion>  regions{DCRegion{Box(lo,hi), 0, len, -1}};
+    Vector<DCCluster> parents;
+    Vector<DCRegion>  done;
+
+    while (!regions.empty())
+    {
+        //
+        // Histograms of all regions at this level of the tree.
+        //
+        const int nr = regions.size();
+        Vector<Long> offset(nr*AMREX_SPACEDIM+1, 0);
+        for (int r = 0; r < nr; r++)
+        {
+            for (int n = 0; n < AMREX_SPACEDIM; n++)
+            {
+                const int i = r*AMREX_SPACEDIM+n;
+                offset[i+1] = offset[i] + regions[r].box.length(n);
+            }
+        }
+        Vector<int> hist(offset.back(), 0);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for
+#endif
+        for (int r = 0; r < nr; r++)
+        {
+            const DCRegion& rg = regions[r];
+            const IntVect& blo = rg.box.smallEnd();
+            const Long* off = offset.data() + r*AMREX_SPACEDIM;
+            for (Long i = rg.begin; i < rg.end; i++)
+            {
+                for (int n = 0; n < AMREX_SPACEDIM; n++)
+                {
+                    hist[off[n] + pts[i][n]-blo[n]]++;
+                }
+            }
+        }
+        ParallelDescriptor::ReduceIntSum(hist.data(), hist.size());
+        //
+        // Shrink each region to the minimal box of its points.
+        //
+        Vector<DCCluster> clusters(nr);
+        for (int r = 0; r < nr; r++)
+        {
+            const DCRegion& rg = regions[r];
+            DCCluster& c = clusters[r];
+            c.begin = rg.begin;
+            c.end   = rg.end;
+            IntVect clo, chi;
+            for (int n = 0; n < AMREX_SPACEDIM; n++)
+            {
+                const int* h = hist.data() + offset[r*AMREX_SPACEDIM+n];
+                const int hlen = rg.box.length(n);
+                int first = 0, last = hlen-1;
+                while (first < hlen && h[first] == 0) first++;
+                if (first == hlen) break;
+                while (h[last] == 0) last--;
+                clo[n] = rg.box.smallEnd(n) + first;
+                chi[n] = rg.box.smallEnd(n) + last;
+                c.hist[n].assign(h+first, h+last+1);
+                if (n == 0) {
+                    for (int v : c.hist[n]) c.count += v;
+                }
+            }
+            if (c.count > 0)
+            {
+                c.box = Box(clo,chi);
+                c.eff = Real(c.count/c.box.d_numPts());
+            }
+        }
+        //
+        // Every process makes the same decisions.
+        //
+        Vector<DCRegion>  next;
+        Vector<DCCluster> next_parents;
+
+        auto split = [&] (DCCluster& c, int invalid_dir, bool trial)
+        {
+            int dir = -1;
+            IntVect cut;
+            Long nlo = DCFindCut(c, invalid_dir, dir, cut);
+            if (nlo <= 0 || nlo >= c.count)
+            {
+                nlo = DCFindCut(c, -1, dir, cut);
+                trial = false;
+            }
+            BL_ASSERT(nlo > 0 && nlo < c.count);
+
+            const Long begin = c.begin;
+            const Long end   = c.end;
+            IntVect* prt_it = std::partition(pts+begin, pts+end, Cut(cut,dir));
+            const Long mid = prt_it - pts;
+
+            Box blo = c.box, bhi = c.box;
+            blo.setBig(dir, cut[dir]-1);
+            bhi.setSmall(dir, cut[dir]);
+
+            int t = -1;
+            if (trial)
+            {
+                t = next_parents.size();
+                c.dir = dir;
+                next_parents.push_back(std::move(c));
+            }
+            next.push_back(DCRegion{blo, begin, mid, t});
+            next.push_back(DCRegion{bhi, mid, end, t});
+        };
+
+        auto process = [&] (DCCluster& c)
+        {
+            if (c.count == 0) return;
+            if (c.eff < eff)
+            {
+                split(c, -1, use_new_chop);
+            }
+            else
+            {
+                done.push_back(DCRegion{c.box, c.begin, c.end, -1});
+            }
+        };
+
+        for (int r = 0; r < nr; r++)
+        {
+            if (regions[r].trial < 0)
+            {
+                process(clusters[r]);
+            }
+            else
+            {
+                //
+                // The two halves of a trial cut are next to each other.
+                // Keep the cut if it improves the efficiency, otherwise
+                // cut the parent in a different direction.
+                //
+                DCCluster& p = parents[regions[r].trial];
+                if (clusters[r].eff > p.eff || clusters[r+1].eff > p.eff)
+                {
+                    process(clusters[r]);
+                    process(clusters[r+1]);
+                }
+                else
+                {
+                    split(p, p.dir, false);
+                }
+                r++;
+            }
+        }
+
+        regions = std::move(next);
+        parents = std::move(next_parents);
+    }
+    //
+    // Intersect the clusters with the proper nesting domain.  The minimal
+    // boxes of the pieces are found with one more reduction.
+    //
+    domba.removeOverlap();
+
+    BoxDomain dom(domba.boxList());
+
+    BoxList blst;
+    bnd.clear();
+
+    for (const DCRegion& rg : done)
+    {
+        bool assume_disjoint_ba = true;
+        if (domba.contains(rg.box,assume_disjoint_ba))
+        {
+            blst.push_back(rg.box);
+        }
+        else
+        {
+            BoxDomain bxdom;
+
+            amrex::intersect(bxdom, dom, rg.box);
+
+            IntVect* p = pts + rg.begin;
+            for (const Box& b : bxdom)
+            {
+                IntVect* prt_it = std::partition(p, pts+rg.end, InBox(b));
+                Vector<int> pbnd(2*AMREX_SPACEDIM, imax);
+                for ( ; p != prt_it; ++p)
+                {
+                    for (int n = 0; n < AMREX_SPACEDIM; n++)
+                    {
+                        pbnd[n]                = std::min(pbnd[n], (*p)[n]);
+                        pbnd[n+AMREX_SPACEDIM] = std::min(pbnd[n+AMREX_SPACEDIM], -(*p)[n]);
+                    }
+                }
+                bnd.insert(bnd.end(), pbnd.begin(), pbnd.end());
+            }
+        }
+    }
+
+    if (!bnd.empty())
+    {
+        ParallelDescriptor::ReduceIntMin(bnd.data(), bnd.size());
+
+        for (int i = 0, N = bnd.size(); i < N; i += 2*AMREX_SPACEDIM)
+        {
+            if (bnd[i] <= -bnd[i+AMREX_SPACEDIM])
+            {
+                for (int n = 0; n < AMREX_SPACEDIM; n++)
+                {
+                    lo[n] = bnd[i+n];
+                    hi[n] = -bnd[i+n+AMREX_SPACEDIM];
+                }
+                blst.push_back(Box(lo,hi));
+            }
+        }
+    }
+
+    domba.clear();
+
+    return blst;
+}
+
 }
@@ -4,8 +4,42 @@
 #include <AMReX_FillPatchUtil_F.H>
 #endif
 
+#include <algorithm>
+
 namespace amrex
 {
+    Vector<CrsePatchCache*> CrsePatchCache::m_caches;
+
+    CrsePatchCache::CrsePatchCache (Vector<FabArrayBase const*> const& crse)
+        : m_crse(crse)
+    {
+        m_caches.push_back(this);
+    }
+
+    CrsePatchCache::~CrsePatchCache ()
+    {
+        m_caches.erase(std::remove(m_caches.begin(), m_caches.end(), this), m_caches.end());
+    }
+
+    void
+    CrsePatchCache::clear () noexcept
+    {
+        m_entries.clear();
+    }
+
+    CrsePatchCache*
+    CrsePatchCache::find (FabArrayBase const& crse) noexcept
+    {
+        // The innermost cache wins.
+        for (auto it = m_caches.rbegin(); it != m_caches.rend(); ++it) {
+            auto const& c = (*it)->m_crse;
+            if (std::find(c.begin(), c.end(), &crse) != c.end()) {
+                return *it;
+            }
+        }
+        return nullptr;
+    }
+
 #ifndef BL_NO_FORT
     // B fields are assumed to be on staggered grids.
     void InterpCrseFineBndryEMfield (InterpEM_t interp_type,
@@ -8,6 +8,52 @@
 
 namespace amrex {
 
+namespace {
+
+// Adds the fluxes on one face of the fine grids, already copied to the
+// coarse grids, to the coarse data.
+void
+reflux_face (MultiFab& mf, const MultiFab& volume, const MultiFab& flux,
+             Orientation face, Real scale, int dcomp, int nc)
+{
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion() && mf.isFusingCandidate()) {
+        auto const& sma = mf.arrays();
+        auto const& fma = flux.const_arrays();
+        auto const& vma = volume.const_arrays();
+        ParallelFor(mf, [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
+        {
+#if (AMREX_SPACEDIM == 1)
+            amrex::ignore_unused(j,k);
+#elif (AMREX_SPACEDIM == 2)
+            amrex::ignore_unused(k);
+#endif
+            fluxreg_reflux(Box(IntVect(AMREX_D_DECL(i,j,k)),IntVect(AMREX_D_DECL(i,j,k))),
+                           sma[box_no], dcomp, fma[box_no], vma[box_no], nc, scale, face);
+        });
+        Gpu::streamSynchronize();
+    } else
+#endif
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            Array4<Real> const& sfab = mf.array(mfi);
+            Array4<Real const> const& ffab = flux.const_array(mfi);
+            Array4<Real const> const& vfab = volume.const_array(mfi);
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA (bx, tbx,
+            {
+                fluxreg_reflux(tbx, sfab, dcomp, ffab, vfab, nc, scale, face);
+            });
+        }
+    }
+}
+
+}
+
 FluxRegister::FluxRegister ()
 {
     fine_level = ncomp = -1;
@@ -167,15 +213,40 @@ FluxRegister::CrseInit (const MultiFab& mflx,
                         int             numcomp,
                         Real            mult,
                         FrOp            op)
+{
+    CrseInit_nowait(mflx,area,dir,srccomp,destcomp,numcomp,mult,op);
+    CrseInit_finish();
+}
+
+void
+FluxRegister::CrseInit_nowait (const MultiFab& mflx,
+                               const MultiFab& area,
+                               int             dir,
+                               int             srccomp,
+                               int             destcomp,
+                               int             numcomp,
+                               Real            mult,
+                               FrOp            op)
 {
     BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= mflx.nComp());
     BL_ASSERT(destcomp >= 0 && destcomp+numcomp <= ncomp);
 
+    for (auto const& d : m_crse_init_data) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(d.dir != dir,
+            "FluxRegister::CrseInit_nowait: unfinished CrseInit_nowait in this direction");
+    }
+
     const Orientation face_lo(dir,Orientation::low);
     const Orientation face_hi(dir,Orientation::high);
 
-    MultiFab mf(mflx.boxArray(),mflx.DistributionMap(),numcomp,0,
-                MFInfo(), mflx.Factory());
+    CrseInitData cid;
+    cid.dir = dir;
+    cid.destcomp = destcomp;
+    cid.numcomp = numcomp;
+    cid.op = op;
+    cid.src = std::make_unique<MultiFab>(mflx.boxArray(),mflx.DistributionMap(),numcomp,0,
+                                         MFInfo(), mflx.Factory());
+    MultiFab& mf = *cid.src;
 
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion() && mflx.isFusingCandidate()) {
@@ -213,52 +284,83 @@ FluxRegister::CrseInit (const MultiFab& mflx,
 
         if (op == FluxRegister::COPY)
         {
-            bndry[face].copyFrom(mf,0,0,destcomp,numcomp);
+            bndry[face].m_mf.ParallelCopy_nowait(mf,0,destcomp,numcomp,0,0);
         }
         else
         {
-            FabSet fs(bndry[face].boxArray(),bndry[face].DistributionMap(),numcomp);
+            cid.tmp[pass] = std::make_unique<FabSet>(bndry[face].boxArray(),
+                                                     bndry[face].DistributionMap(),numcomp);
+
+            cid.tmp[pass]->setVal(0);
+
+            cid.tmp[pass]->m_mf.ParallelCopy_nowait(mf,0,0,numcomp,0,0);
+        }
+    }
+
+    m_crse_init_data.push_back(std::move(cid));
+}
+
+void
+FluxRegister::CrseInit_finish ()
+{
+    for (auto& cid : m_crse_init_data)
+    {
+        const int destcomp = cid.destcomp;
+        const int numcomp = cid.numcomp;
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            const Orientation face(cid.dir, (pass == 0) ? Orientation::low : Orientation::high);
 
-            fs.setVal(0);
+            if (cid.op == FluxRegister::COPY)
+            {
+                bndry[face].m_mf.ParallelCopy_finish();
+            }
+            else
+            {
+                FabSet& fs = *cid.tmp[pass];
 
-            fs.copyFrom(mf,0,0,0,numcomp);
+                fs.m_mf.ParallelCopy_finish();
 
 #ifdef AMREX_USE_GPU
-            using Tag = Array4PairTag<Real>;
-            Vector<Tag> tags;
-            tags.reserve(mflx.local_size()*AMREX_SPACEDIM*2);
+                using Tag = Array4PairTag<Real>;
+                Vector<Tag> tags;
+                tags.reserve(fs.m_mf.local_size());
 #endif
 
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-            for (FabSetIter mfi(fs); mfi.isValid(); ++mfi)
-            {
-                const Box& bx = mfi.validbox();
-                auto const sfab = fs.const_array(mfi);
-                auto       dfab = bndry[face].array(mfi);
+                for (FabSetIter mfi(fs); mfi.isValid(); ++mfi)
+                {
+                    const Box& bx = mfi.validbox();
+                    auto const sfab = fs.const_array(mfi);
+                    auto       dfab = bndry[face].array(mfi);
 #ifdef AMREX_USE_GPU
-                if (Gpu::inLaunchRegion()) {
-                    tags.push_back({dfab, sfab, bx});
-                } else
+                    if (Gpu::inLaunchRegion()) {
+                        tags.push_back({dfab, sfab, bx});
+                    } else
 #endif
-                {
-                    AMREX_LOOP_4D(bx, numcomp, i, j, k, n,
                     {
-                        dfab(i,j,k,n+destcomp) += sfab(i,j,k,n);
-                    });
+                        AMREX_LOOP_4D(bx, numcomp, i, j, k, n,
+                        {
+                            dfab(i,j,k,n+destcomp) += sfab(i,j,k,n);
+                        });
+                    }
                 }
-            }
 
 #ifdef AMREX_USE_GPU
-            ParallelFor(tags, numcomp,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, Tag const& tag) noexcept
-            {
-                tag.dfab(i,j,k,n+destcomp) += tag.sfab(i,j,k,n);
-            });
+                ParallelFor(tags, numcomp,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k, int n, Tag const& tag) noexcept
+                {
+                    tag.dfab(i,j,k,n+destcomp) += tag.sfab(i,j,k,n);
+                });
 #endif
+            }
         }
     }
+
+    m_crse_init_data.clear();
 }
 
 void
@@ -281,6 +383,26 @@ FluxRegister::CrseInit (const MultiFab& mflx,
     CrseInit(mflx,area,dir,srccomp,destcomp,numcomp,mult,op);
 }
 
+void
+FluxRegister::CrseInit_nowait (const MultiFab& mflx,
+                               int             dir,
+                               int             srccomp,
+                               int             destcomp,
+                               int             numcomp,
+                               Real            mult,
+                               FrOp            op)
+{
+    BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= mflx.nComp());
+    BL_ASSERT(destcomp >= 0 && destcomp+numcomp <= ncomp);
+
+    MultiFab area(mflx.boxArray(), mflx.DistributionMap(), 1, 0,
+                  MFInfo(), mflx.Factory());
+
+    area.setVal(1, 0, 1, 0);
+
+    CrseInit_nowait(mflx,area,dir,srccomp,destcomp,numcomp,mult,op);
+}
+
 void
 FluxRegister::CrseAdd (const MultiFab& mflx,
                        const MultiFab& area,
@@ -606,42 +728,115 @@ FluxRegister::Reflux (MultiFab& mf, const MultiFab& volume, Orientation face,
 
     bndry[face].copyTo(flux, 0, scomp, 0, nc, geom.periodicity());
 
-#ifdef AMREX_USE_GPU
-    if (Gpu::inLaunchRegion() && mf.isFusingCandidate()) {
-        auto const& sma = mf.arrays();
-        auto const& fma = flux.const_arrays();
-        auto const& vma = volume.const_arrays();
-        ParallelFor(mf, [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
-        {
-#if (AMREX_SPACEDIM == 1)
-            amrex::ignore_unused(j,k);
-#elif (AMREX_SPACEDIM == 2)
-            amrex::ignore_unused(k);
-#endif
-            fluxreg_reflux(Box(IntVect(AMREX_D_DECL(i,j,k)),IntVect(AMREX_D_DECL(i,j,k))),
-                           sma[box_no], dcomp, fma[box_no], vma[box_no], nc, scale, face);
-        });
-        Gpu::streamSynchronize();
-    } else
-#endif
+    reflux_face(mf, volume, flux, face, scale, dcomp, nc);
+}
+
+void
+FluxRegister::Reflux_nowait (MultiFab&       mf,
+                             const MultiFab& volume,
+                             Real            scale,
+                             int             scomp,
+                             int             dcomp,
+                             int             nc,
+                             const Geometry& geom)
+{
+    for (OrientationIter fi; fi; ++fi)
     {
-#ifdef AMREX_USE_OMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-        for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            const Box& bx = mfi.tilebox();
-            Array4<Real> const& sfab = mf.array(mfi);
-            Array4<Real const> const& ffab = flux.const_array(mfi);
-            Array4<Real const> const& vfab = volume.const_array(mfi);
-            AMREX_LAUNCH_HOST_DEVICE_LAMBDA (bx, tbx,
-            {
-                fluxreg_reflux(tbx, sfab, dcomp, ffab, vfab, nc, scale, face);
-            });
-        }
+        const Orientation& face = fi();
+        Reflux_nowait(mf, volume, face, scale, scomp, dcomp, nc, geom);
     }
 }
 
+void
+FluxRegister::Reflux_nowait (MultiFab&       mf,
+                             const MultiFab& volume,
+                             int             dir,
+                             Real            scale,
+                             int             scomp,
+                             int             dcomp,
+                             int             nc,
+                             const Geometry& geom)
+{
+    for (int s = 0; s < 2; ++s)
+    {
+        Orientation::Side side = (s==0) ? Orientation::low : Orientation::high;
+        Orientation face(dir, side);
+        Reflux_nowait(mf, volume, face, scale, scomp, dcomp, nc, geom);
+    }
+}
+
+void
+FluxRegister::Reflux_nowait (MultiFab&       mf,
+                             Real            scale,
+                             int             scomp,
+                             int             dcomp,
+                             int             nc,
+                             const Geometry& geom)
+{
+    const Real* dx = geom.CellSize();
+
+    m_reflux_volume.push_back(std::make_unique<MultiFab>(mf.boxArray(), mf.DistributionMap(), 1, 0,
+                                                         MFInfo(), mf.Factory()));
+    MultiFab& volume = *m_reflux_volume.back();
+
+    volume.setVal(AMREX_D_TERM(dx[0],*dx[1],*dx[2]), 0, 1, 0);
+
+    Reflux_nowait(mf,volume,scale,scomp,dcomp,nc,geom);
+}
+
+void
+FluxRegister::Reflux_nowait (MultiFab&       mf,
+                             int             dir,
+                             Real            scale,
+                             int             scomp,
+                             int             dcomp,
+                             int             nc,
+                             const Geometry& geom)
+{
+    const Real* dx = geom.CellSize();
+
+    m_reflux_volume.push_back(std::make_unique<MultiFab>(mf.boxArray(), mf.DistributionMap(), 1, 0,
+                                                         MFInfo(), mf.Factory()));
+    MultiFab& volume = *m_reflux_volume.back();
+
+    volume.setVal(AMREX_D_TERM(dx[0],*dx[1],*dx[2]), 0, 1, 0);
+
+    Reflux_nowait(mf,volume,dir,scale,scomp,dcomp,nc,geom);
+}
+
+void
+FluxRegister::Reflux_nowait (MultiFab& mf, const MultiFab& volume, Orientation face,
+                             Real scale, int scomp, int dcomp, int nc, const Geometry& geom)
+{
+    BL_PROFILE("FluxRegister::Reflux_nowait()");
+
+    int idir = face.coordDir();
+
+    auto flux = std::make_unique<MultiFab>(amrex::convert(mf.boxArray(),
+                                                          IntVect::TheDimensionVector(idir)),
+                                           mf.DistributionMap(), nc, 0, MFInfo(), mf.Factory());
+    flux->setVal(0.0);
+
+    flux->ParallelCopy_nowait(bndry[face].m_mf, scomp, 0, nc, 0, 0, geom.periodicity());
+
+    m_reflux_data.push_back(RefluxData{&mf, &volume, face, scale, dcomp, nc, std::move(flux)});
+}
+
+void
+FluxRegister::Reflux_finish ()
+{
+    BL_PROFILE("FluxRegister::Reflux_finish()");
+
+    for (auto& rd : m_reflux_data)
+    {
+        rd.flux->ParallelCopy_finish();
+        reflux_face(*rd.mf, *rd.volume, *rd.flux, rd.face, rd.scale, rd.dcomp, rd.nc);
+    }
+
+    m_reflux_data.clear();
+    m_reflux_volume.clear();
+}
+
 void
 FluxRegister::ClearInternalBorders (const Geometry& geom)
 {
@@ -20,6 +20,9 @@ namespace amrex {
  *
  * CellConservativeQuartic only works with ref ratio of 2 on cpu and gpu.
  *
+ * CellConservativeWENO5 is supported for all dimensions and ref ratios
+ * on cpu and gpu.
+ *
  * FaceDivFree works in 2D and 3D on cpu and gpu.
  * The algorithm is restricted to ref ratio of 2.
  */
@@ -35,6 +38,7 @@ CellConservativeLinear    lincc_interp;
 CellConservativeLinear    cell_cons_interp(0);
 CellConservativeProtected protected_interp;
 CellConservativeQuartic   quartic_interp;
+CellConservativeWENO5     weno5_interp;
 CellBilinear              cell_bilinear_interp;
 CellQuadratic             quadratic_interp;
 
@@ -871,6 +875,106 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
     });
 }
 
+CellConservativeWENO5::~CellConservativeWENO5 () {}
+
+Box
+CellConservativeWENO5::CoarseBox (const Box& fine,
+                                  int        ratio)
+{
+    Box crse(amrex::coarsen(fine,ratio));
+    crse.grow(2);
+    return crse;
+}
+
+Box
+CellConservativeWENO5::CoarseBox (const Box&     fine,
+                                  const IntVect& ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    crse.grow(2);
+    return crse;
+}
+
+void
+CellConservativeWENO5::interp (const FArrayBox&  crse,
+                               int               crse_comp,
+                               FArrayBox&        fine,
+                               int               fine_comp,
+                               int               ncomp,
+                               const Box&        fine_region,
+                               const IntVect&    ratio,
+                               const Geometry&   /* crse_geom */,
+                               const Geometry&   /* fine_geom */,
+                               Vector<BCRec> const& /*bcr*/,
+                               int               /* actual_comp */,
+                               int               /* actual_state */,
+                               RunOn             runon)
+{
+    BL_PROFILE("CellConservativeWENO5::interp()");
+
+    //
+    // Make box which is intersection of fine_region and domain of fine.
+    //
+    Box target_fine_region = fine_region & fine.box();
+
+    Array4<Real const> const& crsearr = crse.const_array(crse_comp);
+    Array4<Real>       const& finearr = fine.array(fine_comp);
+
+    //
+    // One direction at a time.  The intermediate results are fine in the
+    // directions already done and coarse with two ghost cells in the others.
+    //
+    const int rx = ratio[0];
+#if (AMREX_SPACEDIM == 1)
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, target_fine_region, ncomp, i, j, k, n,
+    {
+        ccweno5_interp_x(i, j, k, n, finearr, crsearr, rx);
+    });
+#else
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+
+    const int ry = ratio[1];
+    Box xbx = CoarseBox(target_fine_region, ratio);
+    xbx.setRange(0, target_fine_region.smallEnd(0), target_fine_region.length(0));
+    FArrayBox xfab(xbx, ncomp);
+    Elixir xeli;
+    if (run_on_gpu) xeli = xfab.elixir();
+    Array4<Real> const& xarr = xfab.array();
+    Array4<Real const> const& cxarr = xfab.const_array();
+
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, xbx, ncomp, i, j, k, n,
+    {
+        ccweno5_interp_x(i, j, k, n, xarr, crsearr, rx);
+    });
+
+#if (AMREX_SPACEDIM == 2)
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, target_fine_region, ncomp, i, j, k, n,
+    {
+        ccweno5_interp_y(i, j, k, n, finearr, cxarr, ry);
+    });
+#else
+    const int rz = ratio[2];
+    Box ybx = xbx;
+    ybx.setRange(1, target_fine_region.smallEnd(1), target_fine_region.length(1));
+    FArrayBox yfab(ybx, ncomp);
+    Elixir yeli;
+    if (run_on_gpu) yeli = yfab.elixir();
+    Array4<Real> const& yarr = yfab.array();
+    Array4<Real const> const& cyarr = yfab.const_array();
+
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, ybx, ncomp, i, j, k, n,
+    {
+        ccweno5_interp_y(i, j, k, n, yarr, cxarr, ry);
+    });
+
+    AMREX_HOST_DEVICE_PARALLEL_FOR_4D_FLAG(runon, target_fine_region, ncomp, i, j, k, n,
+    {
+        ccweno5_interp_z(i, j, k, n, finearr, cyarr, rz);
+    });
+#endif
+#endif
+}
+
 FaceDivFree::~FaceDivFree () {}
 
 Box
@@ -1,19 +1,33 @@
 #include <AMReX_Interp_C.H>
 #include <AMReX_MFInterp_C.H>
 #include <AMReX_MFInterpolater.H>
+#include <AMReX_Interpolater.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_MultiFab.H>
 
 namespace amrex {
 
 // Cell centered
-MFPCInterp          mf_pc_interp;
-MFCellConsLinInterp mf_cell_cons_interp(false);
-MFCellConsLinInterp mf_lincc_interp(true);
-MFCellBilinear      mf_cell_bilinear_interp;
+MFPCInterp            mf_pc_interp;
+MFCellConsLinInterp   mf_cell_cons_interp(false);
+MFCellConsLinInterp   mf_lincc_interp(true);
+MFCellConsWENO5Interp mf_weno5_interp;
+MFCellBilinear        mf_cell_bilinear_interp;
 
 // Nodal
-MFNodeBilinear      mf_node_bilinear_interp;
+MFNodeBilinear        mf_node_bilinear_interp;
+
+void
+MFInterpolater::interp_time (MultiFab const& crsemf0, MultiFab const& crsemf1, Real a0, Real a1,
+                             int ccomp, MultiFab& finemf, int fcomp, int nc,
+                             IntVect const& ng, Geometry const& cgeom, Geometry const& fgeom,
+                             Box const& dest_domain, IntVect const& ratio,
+                             Vector<BCRec> const& bcs, int bcomp)
+{
+    MultiFab crsemf(crsemf0.boxArray(), crsemf0.DistributionMap(), nc, 0);
+    MultiFab::LinComb(crsemf, a0, crsemf0, ccomp, a1, crsemf1, ccomp, 0, nc, 0);
+    interp(crsemf, 0, finemf, fcomp, nc, ng, cgeom, fgeom, dest_domain, ratio, bcs, bcomp);
+}
 
 Box
 MFPCInterp::CoarseBox (const Box& fine, const IntVect& ratio)
@@ -67,6 +81,54 @@ MFPCInterp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf, int fco
     }
 }
 
+namespace {
+
+// Conservative linear interpolation in one pass over the coarse cells below
+// the fine cells to be filled.  The coarse data of each box are u(mfi).
+template <typename F>
+void mf_cell_cons_lin_interp_fine (MultiFab& finemf, int fcomp, int nc, IntVect const& ng,
+                                   F const& u, int ccomp, Box const& cdomain,
+                                   Box const& dest_domain, IntVect const& ratio,
+                                   Vector<BCRec> const& bcs, int bcomp, bool do_linear_limiting)
+{
+    BCRec const* pbc = bcs.data() + bcomp;
+#ifdef AMREX_USE_GPU
+    Gpu::DeviceVector<BCRec> d_bc;
+    if (Gpu::inLaunchRegion()) {
+        d_bc.resize(nc);
+        Gpu::copyAsync(Gpu::hostToDevice, bcs.begin()+bcomp, bcs.begin()+bcomp+nc, d_bc.begin());
+        pbc = d_bc.data();
+    }
+#endif
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(finemf); mfi.isValid(); ++mfi) {
+        auto const& fine = finemf.array(mfi);
+        auto const& crse = u(mfi);
+        Box const& fbox = amrex::grow(mfi.validbox(), ng) & dest_domain;
+        Box const& cbox = amrex::coarsen(fbox, ratio);
+        if (do_linear_limiting) {
+            ParallelFor(cbox, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                mf_cell_cons_lin_interp_llslope_fine(i,j,k, fine, fcomp, fbox, crse, ccomp, nc,
+                                                     cdomain, ratio, pbc);
+            });
+        } else {
+            ParallelFor(cbox, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                mf_cell_cons_lin_interp_mcslope_fine(i,j,k, fine, fcomp, fbox, crse, ccomp, nc,
+                                                     cdomain, ratio, pbc);
+            });
+        }
+    }
+
+    Gpu::streamSynchronize();
+}
+
+}
+
 Box
 MFCellConsLinInterp::CoarseBox (const Box& fine, const IntVect& ratio)
 {
@@ -94,6 +156,20 @@ MFCellConsLinInterp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf
 
     Box const& cdomain = cgeom.Domain();
 
+#if (AMREX_SPACEDIM == 1)
+    if (! cgeom.IsSPHERICAL())
+#elif (AMREX_SPACEDIM == 2)
+    if (! cgeom.IsRZ())
+#endif
+    {
+        mf_cell_cons_lin_interp_fine(finemf, fcomp, nc, ng,
+                                     [&] (MFIter const& mfi) { return crsemf.const_array(mfi); },
+                                     ccomp, cdomain, dest_domain, ratio, bcs, bcomp,
+                                     do_linear_limiting);
+        return;
+    }
+
+#if (AMREX_SPACEDIM < 3)
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion()) {
         MultiFab crse_tmp(crsemf.boxArray(), crsemf.DistributionMap(), AMREX_SPACEDIM*nc, 0);
@@ -134,7 +210,7 @@ MFCellConsLinInterp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf
                                                 crse[box_no], ccomp, nc, ratio, drf, rlo);
                 }
             });
-        } else
+        }
 #elif (AMREX_SPACEDIM == 2)
         if (cgeom.IsRZ()) {
             Real drf = fgeom.CellSize(0);
@@ -163,34 +239,8 @@ MFCellConsLinInterp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf
                                                crse[box_no], ccomp, nc, ratio, drf, rlo);
                 }
             });
-        } else
-#endif
-        {
-            if (do_linear_limiting) {
-                ParallelFor(crsemf, IntVect(-1),
-                [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k) noexcept
-                {
-                    mf_cell_cons_lin_interp_llslope(i,j,k, tmp[box_no], crse[box_no], ccomp, nc,
-                                                    cdomain, pbc);
-                });
-            } else {
-                ParallelFor(crsemf, IntVect(-1), nc,
-                [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
-                {
-                    mf_cell_cons_lin_interp_mcslope(i,j,k,n, tmp[box_no], crse[box_no], ccomp, nc,
-                                                    cdomain, ratio, pbc);
-                });
-            }
-
-            ParallelFor(finemf, ng, nc,
-            [=] AMREX_GPU_DEVICE (int box_no, int i, int j, int k, int n) noexcept
-            {
-                if (dest_domain.contains(i,j,k)) {
-                    mf_cell_cons_lin_interp(i,j,k,n, fine[box_no], fcomp, ctmp[box_no],
-                                            crse[box_no], ccomp, nc, ratio);
-                }
-            });
         }
+#endif
 
         Gpu::streamSynchronize();
     } else
@@ -240,7 +290,7 @@ MFCellConsLinInterp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf
                         mf_cell_cons_lin_interp_sph(i, n, fine, fcomp, ctmp,
                                                     crse, ccomp, nc, ratio, drf, rlo);
                     });
-                } else
+                }
 #elif (AMREX_SPACEDIM == 2)
                 if (cgeom.IsRZ()) {
                     Real drf = fgeom.CellSize(0);
@@ -267,35 +317,74 @@ MFCellConsLinInterp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf
                         mf_cell_cons_lin_interp_rz(i, j, n, fine, fcomp, ctmp,
                                                    crse, ccomp, nc, ratio, drf, rlo);
                     });
-                } else
-#endif
-                {
-                    if (do_linear_limiting) {
-                        amrex::LoopConcurrentOnCpu(cbox,
-                        [&] (int i, int j, int k) noexcept
-                        {
-                            mf_cell_cons_lin_interp_llslope(i,j,k, tmp, crse, ccomp, nc,
-                                                            cdomain, pbc);
-                        });
-                    } else {
-                        amrex::LoopConcurrentOnCpu(cbox, nc,
-                        [&] (int i, int j, int k, int n) noexcept
-                        {
-                            mf_cell_cons_lin_interp_mcslope(i,j,k,n, tmp, crse, ccomp, nc,
-                                                            cdomain, ratio, pbc);
-                        });
-                    }
-
-                    amrex::LoopConcurrentOnCpu(fbox, nc,
-                    [&] (int i, int j, int k, int n) noexcept
-                    {
-                        mf_cell_cons_lin_interp(i,j,k,n, fine, fcomp, ctmp,
-                                                crse, ccomp, nc, ratio);
-                    });
                 }
+#endif
             }
         }
     }
+#endif
+}
+
+void
+MFCellConsLinInterp::interp_time (MultiFab const& crsemf0, MultiFab const& crsemf1,
+                                  Real a0, Real a1, int ccomp, MultiFab& finemf, int fcomp, int nc,
+                                  IntVect const& ng, Geometry const& cgeom, Geometry const& fgeom,
+                                  Box const& dest_domain, IntVect const& ratio,
+                                  Vector<BCRec> const& bcs, int bcomp)
+{
+    amrex::ignore_unused(fgeom);
+
+#if (AMREX_SPACEDIM == 1)
+    if (cgeom.IsSPHERICAL())
+#elif (AMREX_SPACEDIM == 2)
+    if (cgeom.IsRZ())
+#endif
+#if (AMREX_SPACEDIM < 3)
+    {
+        MFInterpolater::interp_time(crsemf0, crsemf1, a0, a1, ccomp, finemf, fcomp, nc, ng,
+                                    cgeom, fgeom, dest_domain, ratio, bcs, bcomp);
+        return;
+    }
+#endif
+
+    AMREX_ASSERT(crsemf0.nGrowVect() == 0 && crsemf1.nGrowVect() == 0);
+    mf_cell_cons_lin_interp_fine(finemf, fcomp, nc, ng,
+                                 [&] (MFIter const& mfi) {
+                                     return MFInterpTimeArray(crsemf0.const_array(mfi),
+                                                              crsemf1.const_array(mfi), a0, a1);
+                                 },
+                                 ccomp, cgeom.Domain(), dest_domain, ratio, bcs, bcomp,
+                                 do_linear_limiting);
+}
+
+Box
+MFCellConsWENO5Interp::CoarseBox (const Box& fine, const IntVect& ratio)
+{
+    return weno5_interp.CoarseBox(fine, ratio);
+}
+
+Box
+MFCellConsWENO5Interp::CoarseBox (const Box& fine, int ratio)
+{
+    return CoarseBox(fine, IntVect(ratio));
+}
+
+void
+MFCellConsWENO5Interp::interp (MultiFab const& crsemf, int ccomp, MultiFab& finemf, int fcomp, int nc,
+                               IntVect const& ng, Geometry const& cgeom, Geometry const& fgeom,
+                               Box const& dest_domain, IntVect const& ratio,
+                               Vector<BCRec> const& bcs, int)
+{
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(finemf); mfi.isValid(); ++mfi) {
+        Box const& fbox = amrex::grow(mfi.validbox(), ng) & dest_domain;
+        if (fbox.ok()) {
+            weno5_interp.interp(crsemf[mfi], ccomp, finemf[mfi], fcomp, nc, fbox, ratio,
+                                cgeom, fgeom, bcs, 0, 0, RunOn::Gpu);
+        }
+    }
 }
 
 Box
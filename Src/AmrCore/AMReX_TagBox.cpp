@@ -320,6 +320,79 @@ TagBoxArray::buffer (const IntVect& nbuf)
     }
 }
 
+void
+TagBoxArray::sweep (Array<MultiFab const*,AMREX_SPACEDIM> const& vel, Real dt,
+                    const Geometry& geom)
+{
+    BL_PROFILE("TagBoxArray::sweep()");
+
+    // Cells on the paths are marked SWEPT first so that they do not start
+    // paths of their own.
+    constexpr TagType SWEPT = 3;
+
+    GpuArray<Real,AMREX_SPACEDIM> fac;
+    GpuArray<int,AMREX_SPACEDIM> on_face;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        AMREX_ASSERT(vel[idim]->DistributionMap() == DistributionMap());
+        fac[idim] = dt * geom.InvCellSize(idim);
+        on_face[idim] = vel[idim]->ixType().nodeCentered(idim);
+    }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*this); mfi.isValid(); ++mfi)
+    {
+        Box const& fbx = mfi.fabbox();
+        Array4<TagType> const& tag = this->array(mfi);
+        GpuArray<Array4<Real const>,AMREX_SPACEDIM> u;
+        // The cells where the velocity is known.  Outside, the velocity
+        // of the nearest such cell is used.
+        GpuArray<Box,AMREX_SPACEDIM> ubx;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            u[idim] = vel[idim]->const_array(mfi);
+            ubx[idim] = Box(u[idim]);
+            if (on_face[idim]) {
+                ubx[idim].growHi(idim, -1);
+            }
+        }
+        // The buffer cells in the ghost cells start paths too, so that the
+        // result does not depend on the decomposition into boxes.
+        amrex::ParallelFor(fbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            if (tag(i,j,k) == TagBox::SET || tag(i,j,k) == TagBox::BUF)
+            {
+                IntVect const iv(AMREX_D_DECL(i,j,k));
+                Real d[AMREX_SPACEDIM];
+                Real dmax = 0.0_rt;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    IntVect ivu = iv;
+                    ivu.max(ubx[idim].smallEnd()).min(ubx[idim].bigEnd());
+                    Real v = u[idim](ivu);
+                    if (on_face[idim]) {
+                        v = 0.5_rt*(v + u[idim](ivu+IntVect::TheDimensionVector(idim)));
+                    }
+                    d[idim] = v * fac[idim];
+                    dmax = amrex::max(dmax, std::abs(d[idim]));
+                }
+                int const nsteps = static_cast<int>(std::ceil(dmax));
+                for (int m = 1; m <= nsteps; ++m) {
+                    IntVect ivm = iv;
+                    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                        ivm[idim] += static_cast<int>(std::floor(d[idim]*Real(m)/Real(nsteps)+0.5_rt));
+                    }
+                    if (!fbx.contains(ivm)) { break; }
+                    if (tag(ivm) == TagBox::CLEAR) { tag(ivm) = SWEPT; }
+                }
+            }
+        });
+        amrex::ParallelFor(fbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            if (tag(i,j,k) == SWEPT) { tag(i,j,k) = TagBox::BUF; }
+        });
+    }
+}
+
 void
 TagBoxArray::mapPeriodicRemoveDuplicates (const Geometry& geom)
 {
@@ -423,6 +496,87 @@ TagBoxArray::local_collate_cpu (Gpu::PinnedVector<IntVect>& v) const
     }
 }
 
+#ifdef AMREX_USE_GPU
+namespace {
+//
+// Appends the runs of points that are consecutive in the first direction.
+//
+void
+AppendTagRuns (const IntVect* p, Long n, Vector<int>& runs)
+{
+    Long i = 0;
+    while (i < n)
+    {
+        const IntVect& start = p[i];
+        int len = 1;
+        while (i+len < n)
+        {
+            IntVect next = start;
+            next[0] += len;
+            if (p[i+len] != next) break;
+            ++len;
+        }
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            runs.push_back(start[idim]);
+        }
+        runs.push_back(len);
+        i += len;
+    }
+}
+}
+#endif
+
+void
+TagBoxArray::local_collate_runs (Vector<int>& runs) const
+{
+    runs.clear();
+
+#ifdef AMREX_USE_GPU
+    if (Gpu::inLaunchRegion()) {
+        Gpu::PinnedVector<IntVect> v;
+        local_collate_gpu(v);
+        AppendTagRuns(v.data(), v.size(), runs);
+        return;
+    }
+#endif
+
+    if (this->local_size() == 0) return;
+
+    Vector<Vector<int> > fabruns(this->local_size());
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (MFIter fai(*this); fai.isValid(); ++fai)
+    {
+        Vector<int>& r = fabruns[fai.LocalIndex()];
+        Array4<char const> const& arr = this->const_array(fai);
+        Box const& bx = fai.fabbox();
+        const auto lo = amrex::lbound(bx);
+        const auto hi = amrex::ubound(bx);
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+            int i = lo.x;
+            while (i <= hi.x)
+            {
+                if (arr(i,j,k) == TagBox::CLEAR) {
+                    ++i;
+                } else {
+                    const int istart = i;
+                    while (i <= hi.x && arr(i,j,k) != TagBox::CLEAR) ++i;
+                    AMREX_D_TERM(r.push_back(istart);,
+                                 r.push_back(j);,
+                                 r.push_back(k);)
+                    r.push_back(i-istart);
+                }
+            }
+        }}
+    }
+
+    for (auto const& r : fabruns) {
+        runs.insert(runs.end(), r.begin(), r.end());
+    }
+}
+
 #ifdef AMREX_USE_GPU
 void
 TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v) const
@@ -591,11 +745,8 @@ TagBoxArray::local_collate_gpu (Gpu::PinnedVector<IntVect>& v) const
 #endif
 
 void
-TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+TagBoxArray::local_collate (Gpu::PinnedVector<IntVect>& TheLocalCollateSpace) const
 {
-    BL_PROFILE("TagBoxArray::collate()");
-
-    Gpu::PinnedVector<IntVect> TheLocalCollateSpace;
 #ifdef AMREX_USE_GPU
     if (Gpu::inLaunchRegion()) {
         local_collate_gpu(TheLocalCollateSpace);
@@ -604,72 +755,85 @@ TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
     {
         local_collate_cpu(TheLocalCollateSpace);
     }
+}
+
+void
+TagBoxArray::collate (Gpu::PinnedVector<IntVect>& TheGlobalCollateSpace) const
+{
+    BL_PROFILE("TagBoxArray::collate()");
+
+#ifdef BL_USE_MPI
+    //
+    // The tags are sent as runs of cells in the first direction, which
+    // takes much less memory and bandwidth than one IntVect per tag.
+    //
+    constexpr int run_size = AMREX_SPACEDIM+1;
 
-    Long count = TheLocalCollateSpace.size();
+    Vector<int> runs;
+    local_collate_runs(runs);
+
+    Long count = 0;
+    for (Long i = AMREX_SPACEDIM, N = runs.size(); i < N; i += run_size) {
+        count += runs[i];
+    }
 
     //
-    // The total number of tags system wide that must be collated.
+    // The total numbers of tags and of ints system wide that must be
+    // collated.  The ints are gathered with int counts and offsets.
     //
-    Long numtags = count;
-    ParallelDescriptor::ReduceLongSum(numtags);
+    Long totals[2] = {count, static_cast<Long>(runs.size())};
+    ParallelDescriptor::ReduceLongSum(totals, 2);
+    const Long numtags = totals[0];
 
     if (numtags == 0) {
         TheGlobalCollateSpace.clear();
         return;
-    } else if (numtags > static_cast<Long>(std::numeric_limits<int>::max())) {
+    } else if (totals[1] > static_cast<Long>(std::numeric_limits<int>::max())) {
         // xxxxx todo
         amrex::Abort("TagBoxArray::collate: Too many tags. Using a larger blocking factor might help. Please file an issue on github");
     }
 
-#ifdef BL_USE_MPI
-    //
-    // On I/O proc. this holds all tags after they've been gather'd.
-    // On other procs. non-mempty signals size is not zero.
-    //
-    if (ParallelDescriptor::IOProcessor()) {
-        TheGlobalCollateSpace.resize(numtags);
-    } else {
-        TheGlobalCollateSpace.resize(1);
-    }
-
     //
-    // Tell root CPU how many tags each CPU will be sending.
+    // Tell root CPU how many ints each CPU will be sending.
     //
     const int IOProcNumber = ParallelDescriptor::IOProcessorNumber();
-    const std::vector<int>& countvec = ParallelDescriptor::Gather(static_cast<int>(count),
-                                                                  IOProcNumber);
+    const int nints = static_cast<int>(runs.size());
+    const std::vector<int>& countvec = ParallelDescriptor::Gather(nints, IOProcNumber);
     std::vector<int> offset(countvec.size(),0);
+    Long nints_total = 0;
     if (ParallelDescriptor::IOProcessor()) {
         for (int i = 1, N = offset.size(); i < N; i++) {
             offset[i] = offset[i-1] + countvec[i-1];
         }
+        nints_total = offset.back() + countvec.back();
     }
     //
-    // Gather all the tags to IOProcNumber into TheGlobalCollateSpace.
+    // Gather all the runs to IOProcNumber.
     //
-    const IntVect* psend = (count > 0) ? TheLocalCollateSpace.data() : nullptr;
-    IntVect* precv = TheGlobalCollateSpace.data();
-
-    // Issues have been observed with the following call at very large scale when using
-    // FujitsuMPI. The issue seems to be related to the use of MPI_Datatype. We can
-    // bypasses the issue by exchanging simpler integer arrays.
-#if !(defined(__FUJITSU) || defined(__CLANG_FUJITSU))
-    ParallelDescriptor::Gatherv(psend, count, precv, countvec, offset, IOProcNumber);
-#else
-    const int* psend_int = psend->begin();
-    int* precv_int = precv->begin();
-    Long count_int = count * AMREX_SPACEDIM;
-    auto countvec_int = std::vector<int>(countvec.size());
-    auto offset_int = std::vector<int>(offset.size());
-    const auto mul_funct = [](const auto el){return el*AMREX_SPACEDIM;};
-    std::transform(countvec.begin(), countvec.end(), countvec_int.begin(), mul_funct);
-    std::transform(offset.begin(), offset.end(), offset_int.begin(), mul_funct);
-    ParallelDescriptor::Gatherv(
-        psend_int, count_int, precv_int, countvec_int, offset_int, IOProcNumber);
-#endif
+    Vector<int> allruns(std::max(nints_total,Long(1)));
+    ParallelDescriptor::Gatherv(runs.data(), nints, allruns.data(), countvec, offset,
+                                IOProcNumber);
+    runs.clear();
 
+    //
+    // On I/O proc. this holds all tags after they've been gather'd.
+    // On other procs. non-mempty signals size is not zero.
+    //
+    if (ParallelDescriptor::IOProcessor()) {
+        TheGlobalCollateSpace.resize(numtags);
+        IntVect* p = TheGlobalCollateSpace.data();
+        for (Long i = 0; i < nints_total; i += run_size) {
+            IntVect iv(&allruns[i]);
+            for (int n = 0, len = allruns[i+AMREX_SPACEDIM]; n < len; ++n) {
+                *p++ = iv;
+                ++iv[0];
+            }
+        }
+    } else {
+        TheGlobalCollateSpace.resize(1);
+    }
 #else
-    TheGlobalCollateSpace = std::move(TheLocalCollateSpace);
+    local_collate(TheGlobalCollateSpace);
 #endif
 }
 
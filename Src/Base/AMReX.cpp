@@ -41,6 +41,7 @@
 #include <AMReX_iMultiFab.H>
 #include <AMReX_VisMF.H>
 #include <AMReX_AsyncOut.H>
+#include <AMReX_StartupCache.H>
 #endif
 
 #ifdef BL_LAZY
@@ -523,6 +524,7 @@ amrex::Initialize (int& argc, char**& argv, bool build_parm_parse,
     iMultiFab::Initialize();
     VisMF::Initialize();
     AsyncOut::Initialize();
+    StartupCache::Initialize();
 
 #ifdef AMREX_USE_EB
     EB2::Initialize();
@@ -599,6 +601,10 @@ amrex::Initialize (int& argc, char**& argv, bool build_parm_parse,
 
     BL_TINY_PROFILE_INITIALIZE();
 
+#ifdef AMREX_MEM_PROFILING
+    MemProfiler::StartTracking();
+#endif
+
     AMReX::push(new AMReX());
     return AMReX::top();
 }
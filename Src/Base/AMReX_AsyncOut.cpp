@@ -6,6 +6,9 @@
 #include <AMReX_Utility.H>
 #include <AMReX.H>
 
+#include <condition_variable>
+#include <mutex>
+
 namespace amrex {
 namespace AsyncOut {
 
@@ -13,12 +16,17 @@ namespace {
 
 int s_asyncout = false;
 int s_noutfiles = 64;
+Long s_max_staging = 0; // <= 0: no limit
 MPI_Comm s_comm = MPI_COMM_NULL;
 
 std::unique_ptr<BackgroundThread> s_thread;
 
 WriteInfo s_info;
 
+std::mutex s_staging_mutx;
+std::condition_variable s_staging_cond;
+Long s_staging_bytes = 0;
+
 }
 
 void Initialize ()
@@ -28,6 +36,7 @@ void Initialize ()
     ParmParse pp("amrex");
     pp.queryAdd("async_out", s_asyncout);
     pp.queryAdd("async_out_nfiles", s_noutfiles);
+    pp.queryAdd("async_out_max_staging", s_max_staging);
 
     int nprocs = ParallelDescriptor::NProcs();
     s_noutfiles = std::min(s_noutfiles, nprocs);
@@ -110,6 +119,57 @@ void Finish ()
     }
 }
 
+WriteHandle Fence ()
+{
+    if (s_thread) {
+        auto p = std::make_shared<std::promise<void> >();
+        WriteHandle h(p->get_future().share());
+        s_thread->Submit([=] () { p->set_value(); });
+        return h;
+    } else {
+        return WriteHandle();
+    }
+}
+
+bool WriteHandle::isReady () const
+{
+    return !m_future.valid() ||
+        m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void WriteHandle::wait () const
+{
+    if (m_future.valid()) {
+        m_future.wait();
+    }
+}
+
+void AcquireStaging (Long nbytes)
+{
+    std::unique_lock<std::mutex> lck(s_staging_mutx);
+    if (s_max_staging > 0) {
+        s_staging_cond.wait(lck, [=] () -> bool {
+            return s_staging_bytes == 0 || s_staging_bytes + nbytes <= s_max_staging;
+        });
+    }
+    s_staging_bytes += nbytes;
+}
+
+void ReleaseStaging (Long nbytes)
+{
+    {
+        std::lock_guard<std::mutex> lck(s_staging_mutx);
+        s_staging_bytes -= nbytes;
+    }
+    s_staging_cond.notify_all();
+}
+
+Long StagingBytesInUse ()
+{
+    std::lock_guard<std::mutex> lck(s_staging_mutx);
+    return s_staging_bytes;
+}
+
 void Wait ()
 {
 #ifdef AMREX_USE_MPI
@@ -1,14 +1,24 @@
 #include <AMReX_BArena.H>
+#ifdef AMREX_MEM_PROFILING
+#include <AMReX_MemProfiler.H>
+#endif
 
 void*
 amrex::BArena::alloc (std::size_t sz_)
 {
-    return std::malloc(sz_);
+    void* pt = std::malloc(sz_);
+#ifdef AMREX_MEM_PROFILING
+    MemProfiler::TrackAlloc(pt, sz_);
+#endif
+    return pt;
 }
 
 void
 amrex::BArena::free (void* pt)
 {
+#ifdef AMREX_MEM_PROFILING
+    MemProfiler::TrackFree(pt);
+#endif
     std::free(pt);
 }
 
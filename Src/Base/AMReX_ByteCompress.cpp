@@ -0,0 +1,183 @@
+#include <AMReX_ByteCompress.H>
+#include <AMReX.H>
+
+#include <cstdint>
+#include <cstring>
+
+namespace amrex {
+namespace ByteCompress {
+
+void Shuffle (const char* in, char* out, std::size_t n, std::size_t elem_size) noexcept
+{
+    for (std::size_t b = 0; b < elem_size; ++b) {
+        char* AMREX_RESTRICT po = out + b*n;
+        const char* AMREX_RESTRICT pi = in + b;
+        for (std::size_t i = 0; i < n; ++i) {
+            po[i] = pi[i*elem_size];
+        }
+    }
+}
+
+void Unshuffle (const char* in, char* out, std::size_t n, std::size_t elem_size) noexcept
+{
+    for (std::size_t b = 0; b < elem_size; ++b) {
+        const char* AMREX_RESTRICT pi = in + b*n;
+        char* AMREX_RESTRICT po = out + b;
+        for (std::size_t i = 0; i < n; ++i) {
+            po[i*elem_size] = pi[i];
+        }
+    }
+}
+
+//
+// The compressed stream is a sequence of (literals, match) pairs.  Each pair
+// starts with a token byte.  Its upper 4 bits hold the number of literals and
+// its lower 4 bits the match length minus kMinMatch.  A value of 15 means
+// that extra length bytes follow, each adding up to 255.  The literals come
+// next, followed by a 2-byte little-endian offset into the already decoded
+// output and the extra match length bytes.  The last pair has no match.
+//
+namespace {
+
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kMaxOffset = 65535;
+constexpr int kHashBits = 14;
+
+inline std::uint32_t read32 (const unsigned char* p) noexcept
+{
+    std::uint32_t r;
+    std::memcpy(&r, p, sizeof(r));
+    return r;
+}
+
+inline std::uint32_t hash4 (std::uint32_t v) noexcept
+{
+    return (v * 2654435761U) >> (32 - kHashBits);
+}
+
+inline void putLength (std::size_t len, Vector<char>& out)
+{
+    while (len >= 255) {
+        out.push_back(static_cast<char>(255));
+        len -= 255;
+    }
+    out.push_back(static_cast<char>(len));
+}
+
+void putSequence (const unsigned char* lit, std::size_t nlit,
+                  std::size_t offset, std::size_t mlen, Vector<char>& out)
+{
+    const std::size_t mcode = (mlen > 0) ? mlen - kMinMatch : 0;
+    unsigned char token = static_cast<unsigned char>(((nlit < 15) ? nlit : 15) << 4);
+    token |= static_cast<unsigned char>((mcode < 15) ? mcode : 15);
+    out.push_back(static_cast<char>(token));
+    if (nlit >= 15) { putLength(nlit-15, out); }
+    out.insert(out.end(), lit, lit+nlit);
+    if (mlen > 0) {
+        out.push_back(static_cast<char>(offset & 0xff));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (mcode >= 15) { putLength(mcode-15, out); }
+    }
+}
+
+inline std::size_t getLength (const unsigned char*& ip, const unsigned char* iend)
+{
+    std::size_t len = 0;
+    unsigned char c;
+    do {
+        if (ip >= iend) { amrex::Abort("ByteCompress::LZDecompress: corrupted input"); }
+        c = *ip++;
+        len += c;
+    } while (c == 255);
+    return len;
+}
+
+}
+
+void LZCompress (const char* in, std::size_t nbytes, Vector<char>& out)
+{
+    if (nbytes == 0) { return; }
+
+    out.reserve(out.size() + nbytes + nbytes/255 + 16);
+
+    const auto* base = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* iend = base + nbytes;
+    const unsigned char* ip = base;
+    const unsigned char* anchor = base;
+
+    Vector<std::int64_t> table(std::size_t(1) << kHashBits, -1);
+
+    while (ip + kMinMatch <= iend)
+    {
+        const std::uint32_t v = read32(ip);
+        const std::uint32_t h = hash4(v);
+        const std::int64_t cand = table[h];
+        table[h] = ip - base;
+
+        if (cand >= 0 && static_cast<std::size_t>(ip - base - cand) <= kMaxOffset
+            && read32(base+cand) == v)
+        {
+            const unsigned char* mp = base + cand + kMinMatch;
+            const unsigned char* p = ip + kMinMatch;
+            while (p < iend && *p == *mp) { ++p; ++mp; }
+            const std::size_t mlen = p - ip;
+            putSequence(anchor, ip-anchor, ip-(base+cand), mlen, out);
+            ip = p;
+            anchor = ip;
+        } else {
+            ++ip;
+        }
+    }
+
+    if (anchor < iend) {
+        putSequence(anchor, iend-anchor, 0, 0, out);
+    }
+}
+
+void LZDecompress (const char* in, std::size_t nbytes_in, char* out, std::size_t nbytes_out)
+{
+    const auto* ip = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* iend = ip + nbytes_in;
+    auto* op = reinterpret_cast<unsigned char*>(out);
+    const unsigned char* obase = op;
+    const unsigned char* oend = op + nbytes_out;
+
+    while (ip < iend)
+    {
+        const unsigned char token = *ip++;
+        std::size_t nlit = token >> 4;
+        if (nlit == 15) { nlit += getLength(ip, iend); }
+        if (nlit > static_cast<std::size_t>(iend-ip) ||
+            nlit > static_cast<std::size_t>(oend-op)) {
+            amrex::Abort("ByteCompress::LZDecompress: corrupted input");
+        }
+        std::memcpy(op, ip, nlit);
+        op += nlit;
+        ip += nlit;
+
+        if (ip >= iend) { break; } // the last sequence has no match
+
+        if (iend-ip < 2) { amrex::Abort("ByteCompress::LZDecompress: corrupted input"); }
+        const std::size_t offset = std::size_t(ip[0]) | (std::size_t(ip[1]) << 8);
+        ip += 2;
+        std::size_t mlen = token & 0xf;
+        if (mlen == 15) { mlen += getLength(ip, iend); }
+        mlen += kMinMatch;
+
+        if (offset == 0 || offset > static_cast<std::size_t>(op-obase) ||
+            mlen > static_cast<std::size_t>(oend-op)) {
+            amrex::Abort("ByteCompress::LZDecompress: corrupted input");
+        }
+        const unsigned char* mp = op - offset;
+        for (std::size_t i = 0; i < mlen; ++i) { // may overlap
+            op[i] = mp[i];
+        }
+        op += mlen;
+    }
+
+    if (op != oend) {
+        amrex::Abort("ByteCompress::LZDecompress: size mismatch");
+    }
+}
+
+}}
@@ -3,6 +3,9 @@
 #include <AMReX_BLassert.H>
 #include <AMReX_Gpu.H>
 #include <AMReX_ParallelReduce.H>
+#ifdef AMREX_MEM_PROFILING
+#include <AMReX_MemProfiler.H>
+#endif
 
 #include <utility>
 #include <cstring>
@@ -109,6 +112,10 @@ CArena::alloc (std::size_t nbytes)
 
     BL_ASSERT(!(vp == 0));
 
+#ifdef AMREX_MEM_PROFILING
+    MemProfiler::TrackAlloc(vp, nbytes);
+#endif
+
     return vp;
 }
 
@@ -136,6 +143,10 @@ CArena::free (void* vp)
 
     m_actually_used -= busy_it->size();
 
+#ifdef AMREX_MEM_PROFILING
+    MemProfiler::TrackFree(vp);
+#endif
+
     //
     // Put free'd block on free list and save iterator to insert()ed position.
     //
@@ -18,6 +18,7 @@
 #include <vector>
 #include <queue>
 #include <algorithm>
+#include <functional>
 #include <numeric>
 #include <string>
 #include <cstring>
@@ -1688,6 +1689,78 @@ DistributionMapping::makeSFC (const Vector<Real>& rcost, const BoxArray& ba, Rea
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeIncremental (const BoxArray& ba, const BoxArray& old_ba,
+                                      const DistributionMapping& old_dm)
+{
+    BL_PROFILE("makeIncremental");
+
+    const int nprocs = ParallelContext::NProcsSub();
+    const int N = static_cast<int>(ba.size());
+
+    // The load balance is done in the ranks of the current sub-communicator.
+    // The old owners outside of it are translated to an invalid rank.
+    const Vector<int>& old_pmap = old_dm.ProcessorMap();
+    Vector<int> old_lpmap(old_pmap.size());
+    ParallelContext::global_to_local_rank(old_lpmap.data(), old_pmap.data(),
+                                          static_cast<int>(old_pmap.size()));
+
+    Vector<int> pmap(N, -1);
+    Vector<Long> ncells(nprocs, 0);
+    int nkept = 0;
+
+    std::vector< std::pair<int,Box> > isects;
+    for (int i = 0; i < N; ++i)
+    {
+        const Box& bx = ba[i];
+        old_ba.intersections(bx, isects);
+        for (auto const& is : isects)
+        {
+            const int iold = is.first;
+            const int lrank = old_lpmap[iold];
+            if (old_ba[iold] == bx && lrank >= 0 && lrank < nprocs)
+            {
+                pmap[i] = lrank;
+                ncells[pmap[i]] += bx.numPts();
+                ++nkept;
+                break;
+            }
+        }
+    }
+
+    if (nkept == 0) {
+        return DistributionMapping(ba, nprocs);
+    }
+
+    Vector<int> ord;
+    ord.reserve(N-nkept);
+    for (int i = 0; i < N; ++i) {
+        if (pmap[i] < 0) ord.push_back(i);
+    }
+    std::stable_sort(ord.begin(), ord.end(), [&] (int a, int b) -> bool
+                                             { return ba[a].numPts() > ba[b].numPts(); });
+
+    using LoadProc = std::pair<Long,int>;
+    std::priority_queue<LoadProc, std::vector<LoadProc>, std::greater<LoadProc> > procs;
+    for (int p = 0; p < nprocs; ++p) {
+        procs.push(LoadProc(ncells[p], p));
+    }
+    for (int i : ord)
+    {
+        LoadProc lp = procs.top();
+        procs.pop();
+        pmap[i] = lp.second;
+        lp.first += ba[i].numPts();
+        procs.push(lp);
+    }
+
+    for (auto& p : pmap) {
+        p = ParallelContext::local_to_global_rank(p);
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
 DistributionMapping
 DistributionMapping::makeSFC (const LayoutData<Real>& rcost_local,
                               Real& currentEfficiency, Real& proposedEfficiency,
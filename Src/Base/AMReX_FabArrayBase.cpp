@@ -4,6 +4,7 @@
 #include <AMReX_Utility.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_FArrayBox.H>
+#include <AMReX_LayoutData.H>
 #include <AMReX_NonLocalBC.H>
 
 #include <AMReX_BArena.H>
@@ -1962,9 +1963,74 @@ FabArrayBase::FPinfo::bytes () const
     Long cnt = sizeof(FabArrayBase::FPinfo);
     cnt += sizeof(Box) * (ba_crse_patch.capacity() + ba_fine_patch.capacity());
     cnt += sizeof(int) * dm_patch.capacity();
+    for (auto const& cs : m_crse_stage) {
+        cnt += sizeof(CrseStage) + sizeof(Box) * cs->ba.capacity() + sizeof(int) * cs->dm.capacity();
+    }
     return cnt;
 }
 
+const FabArrayBase::FPinfo::CrseStage&
+FabArrayBase::FPinfo::TheCrseStage (const BoxArray& cba, const DistributionMapping& cdm,
+                                    const Periodicity& period) const
+{
+    for (auto const& cs : m_crse_stage) {
+        if (cs->crse_ba.getRefID() == cba.getRefID() &&
+            cs->crse_dm.getRefID() == cdm.getRefID() &&
+            cs->period == period)
+        {
+            return *cs;
+        }
+    }
+
+    BL_PROFILE("FPinfo::TheCrseStage()");
+
+    BoxList bl;
+    Vector<int> pmap;
+    {
+        std::vector<BoxList> bl_under(cba.size());
+        std::vector< std::pair<int,Box> > isects;
+        auto const& pshifts = period.shiftIntVect();
+        for (int ip = 0, np = ba_crse_patch.size(); ip < np; ++ip) {
+            for (auto const& iv : pshifts) {
+                cba.intersections(ba_crse_patch[ip]+iv, isects);
+                for (auto const& is : isects) {
+                    bl_under[is.first].push_back(is.second);
+                }
+            }
+        }
+        for (int ic = 0, nc = cba.size(); ic < nc; ++ic) {
+            if (!bl_under[ic].isEmpty()) {
+                for (auto const& b : amrex::removeOverlap(bl_under[ic])) {
+                    bl.push_back(b);
+                    pmap.push_back(cdm[ic]);
+                }
+            }
+        }
+    }
+
+    m_crse_stage.emplace_back(std::make_unique<CrseStage>());
+    auto& cs = *m_crse_stage.back();
+    cs.crse_ba = cba;
+    cs.crse_dm = cdm;
+    cs.period = period;
+    cs.ba = BoxArray(std::move(bl));
+    cs.dm = DistributionMapping(std::move(pmap));
+    cs.anchor = std::make_unique<LayoutData<int> >(cs.ba, cs.dm);
+
+    if (!m_crse_patch_anchor) {
+        m_crse_patch_anchor = std::make_unique<LayoutData<int> >(ba_crse_patch, dm_patch);
+        m_fine_patch_anchor = std::make_unique<LayoutData<int> >(ba_fine_patch, dm_patch);
+    }
+
+#ifdef AMREX_MEM_PROFILING
+    m_FPinfo_stats.bytes += sizeof(CrseStage) + sizeof(Box) * cs.ba.capacity()
+        + sizeof(int) * cs.dm.capacity();
+    m_FPinfo_stats.bytes_hwm = std::max(m_FPinfo_stats.bytes_hwm, m_FPinfo_stats.bytes);
+#endif
+
+    return cs;
+}
+
 const FabArrayBase::FPinfo&
 FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
                          const FabArrayBase& dstfa,
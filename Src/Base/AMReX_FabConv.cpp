@@ -5,6 +5,8 @@
 #include <AMReX_REAL.H>
 #include <AMReX_Utility.H>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -912,6 +914,171 @@ operator>> (std::istream&   is,
     return is;
 }
 
+//
+// Fast paths for data in IEEE single or double precision that differ from
+// the native format only in precision and/or byte order.  This covers
+// reading single precision plotfiles into double precision and reading
+// files written on machines of the other endianness.  The loops below work
+// directly on the (possibly unaligned) I/O buffers and are simple enough to
+// be vectorized by the compiler.
+//
+
+namespace {
+
+enum struct IEEEOrder { none, native, swapped };
+
+IEEEOrder
+ieee_order (const RealDescriptor& rd, const RealDescriptor& native)
+{
+    if (rd.formatarray() != native.formatarray()) { return IEEEOrder::none; }
+    const int  n   = rd.numBytes();
+    const int* ord = rd.order();
+    const int* nat = native.order();
+    bool same = true, reversed = true;
+    for (int i = 0; i < n; ++i) {
+        same     = same     && (ord[i] == nat[i]);
+        reversed = reversed && (ord[i] == nat[n-1-i]);
+    }
+    return same ? IEEEOrder::native : (reversed ? IEEEOrder::swapped : IEEEOrder::none);
+}
+
+AMREX_FORCE_INLINE std::uint32_t byte_swap (std::uint32_t x) noexcept
+{
+    return ((x & 0x000000ffU) << 24) | ((x & 0x0000ff00U) <<  8) |
+           ((x & 0x00ff0000U) >>  8) | ((x & 0xff000000U) >> 24);
+}
+
+AMREX_FORCE_INLINE std::uint64_t byte_swap (std::uint64_t x) noexcept
+{
+    return (std::uint64_t(byte_swap(std::uint32_t(x))) << 32) |
+            std::uint64_t(byte_swap(std::uint32_t(x >> 32)));
+}
+
+template <typename U>
+void
+ieee_swap (char* out, const char* in, Long nitems) noexcept
+{
+    AMREX_PRAGMA_SIMD
+    for (Long i = 0; i < nitems; ++i) {
+        U x;
+        std::memcpy(&x, in+i*sizeof(U), sizeof(U));
+        x = byte_swap(x);
+        std::memcpy(out+i*sizeof(U), &x, sizeof(U));
+    }
+}
+
+template <typename UI, typename FI, typename UO, typename FO, bool swap_in, bool swap_out>
+void
+ieee_convert_block (char* out, const char* in, Long nitems) noexcept
+{
+    AMREX_PRAGMA_SIMD
+    for (Long i = 0; i < nitems; ++i) {
+        UI ui;
+        std::memcpy(&ui, in+i*sizeof(UI), sizeof(UI));
+        if (swap_in) { ui = byte_swap(ui); }
+        FI x;
+        std::memcpy(&x, &ui, sizeof(FI));
+        auto y = static_cast<FO>(x);
+        UO uo;
+        std::memcpy(&uo, &y, sizeof(UO));
+        if (swap_out) { uo = byte_swap(uo); }
+        std::memcpy(out+i*sizeof(UO), &uo, sizeof(UO));
+    }
+}
+
+//
+// Convert between float and double.  The input goes through a small local
+// block so that in may overlap the end of out, which lets readers widen
+// data in place in the output array.
+//
+template <typename UI, typename FI, typename UO, typename FO, bool swap_in, bool swap_out>
+void
+ieee_convert (char* out, const char* in, Long nitems) noexcept
+{
+    constexpr Long nblock = 256;
+    char tmp[nblock*sizeof(UI)];
+    for (Long ib = 0; ib < nitems; ib += nblock) {
+        const Long n = std::min(nblock, nitems-ib);
+        std::memcpy(tmp, in+ib*sizeof(UI), n*sizeof(UI));
+        ieee_convert_block<UI,FI,UO,FO,swap_in,swap_out>(out+ib*sizeof(UO), tmp, n);
+    }
+}
+
+template <typename UI, typename FI, typename UO, typename FO>
+void
+ieee_convert (char* out, const char* in, Long nitems, bool swap_in, bool swap_out) noexcept
+{
+    if (swap_in) {
+        if (swap_out) {
+            ieee_convert<UI,FI,UO,FO,true,true>(out, in, nitems);
+        } else {
+            ieee_convert<UI,FI,UO,FO,true,false>(out, in, nitems);
+        }
+    } else {
+        if (swap_out) {
+            ieee_convert<UI,FI,UO,FO,false,true>(out, in, nitems);
+        } else {
+            ieee_convert<UI,FI,UO,FO,false,false>(out, in, nitems);
+        }
+    }
+}
+
+//
+// Returns false if neither descriptor pair is handled here.  out may be
+// equal to in if both formats have the same size, or in may point to the
+// last nitems*ird.numBytes() bytes of out when widening.
+//
+bool
+PD_convert_ieee (void*                 out,
+                 const void*           in,
+                 Long                  nitems,
+                 const RealDescriptor& ord,
+                 const RealDescriptor& ird)
+{
+    static_assert(sizeof(float) == 4 && sizeof(double) == 8,
+                  "PD_convert_ieee assumes IEEE float and double");
+
+    const RealDescriptor& n32 = FPC::Native32RealDescriptor();
+    const RealDescriptor& n64 = FPC::Native64RealDescriptor();
+
+    const IEEEOrder i32 = ieee_order(ird, n32);
+    const IEEEOrder i64 = (i32 == IEEEOrder::none) ? ieee_order(ird, n64) : IEEEOrder::none;
+    if (i32 == IEEEOrder::none && i64 == IEEEOrder::none) { return false; }
+
+    const IEEEOrder o32 = ieee_order(ord, n32);
+    const IEEEOrder o64 = (o32 == IEEEOrder::none) ? ieee_order(ord, n64) : IEEEOrder::none;
+    if (o32 == IEEEOrder::none && o64 == IEEEOrder::none) { return false; }
+
+    auto* pout = static_cast<char*>(out);
+    const auto* pin = static_cast<const char*>(in);
+
+    const IEEEOrder io = (i32 != IEEEOrder::none) ? i32 : i64;
+    const IEEEOrder oo = (o32 != IEEEOrder::none) ? o32 : o64;
+    const bool swap_in  = (io == IEEEOrder::swapped);
+    const bool swap_out = (oo == IEEEOrder::swapped);
+
+    if (i32 != IEEEOrder::none && o32 != IEEEOrder::none) {
+        if (swap_in == swap_out) {
+            if (pout != pin) { std::memcpy(pout, pin, nitems*sizeof(float)); }
+        } else {
+            ieee_swap<std::uint32_t>(pout, pin, nitems);
+        }
+    } else if (i64 != IEEEOrder::none && o64 != IEEEOrder::none) {
+        if (swap_in == swap_out) {
+            if (pout != pin) { std::memcpy(pout, pin, nitems*sizeof(double)); }
+        } else {
+            ieee_swap<std::uint64_t>(pout, pin, nitems);
+        }
+    } else if (i32 != IEEEOrder::none) {
+        ieee_convert<std::uint32_t,float,std::uint64_t,double>(pout, pin, nitems, swap_in, swap_out);
+    } else {
+        ieee_convert<std::uint64_t,double,std::uint32_t,float>(pout, pin, nitems, swap_in, swap_out);
+    }
+    return true;
+}
+
+}
+
 static
 void
 PD_convert (void*                 out,
@@ -928,25 +1095,17 @@ PD_convert (void*                 out,
     {
         size_t n = size_t(nitems);
         BL_ASSERT(int(n) == nitems);
-        memcpy(out, in, n*ord.numBytes());
+        if (out != in) {
+            memcpy(out, in, n*ord.numBytes());
+        }
+    }
+    else if (boffs == 0 && ! onescmp && PD_convert_ieee(out, in, nitems, ord, ird)) {
+        // done
     }
     else if (ord.formatarray() == ird.formatarray() && boffs == 0 && ! onescmp) {
         permute_real_word_order(out, in, nitems,
                                 ord.order(), ird.order(), ord.numBytes());
     }
-    else if (ird == FPC::NativeRealDescriptor() && ord == FPC::Native32RealDescriptor()) {
-      auto rIn = static_cast<const char*>(in);
-      auto rOut= static_cast<char*>(out);
-      for(Long i(0); i < nitems; ++i) {
-        Real x;
-        float y;
-        std::memcpy(&x, rIn, sizeof(Real));
-        y = static_cast<float>(x);
-        std::memcpy(rOut, &y, sizeof(float));
-        rOut += sizeof(float);
-        rIn += sizeof(Real);
-      }
-    }
     else
     {
         PD_fconvert(out, in, nitems, boffs, ord.format(), ord.order(),
@@ -956,6 +1115,62 @@ PD_convert (void*                 out,
     }
 }
 
+//
+// Read nitems from istream in RealDescriptor format id and convert them to
+// the native format nd of T.  If id is an IEEE format no larger than nd, the
+// data are read straight into the end of each chunk of out and converted in
+// place while streaming.  Otherwise they go through an intermediate buffer.
+//
+
+template <typename T>
+static
+void
+PD_read_convert (T*                    out,
+                 Long                  nitems,
+                 std::istream&         is,
+                 const RealDescriptor& id,
+                 const RealDescriptor& nd,
+                 Long                  buffSize,
+                 bool                  fix_denormals)
+{
+    const int ibytes = id.numBytes();
+    const int obytes = nd.numBytes();
+    const bool in_place = (ibytes <= obytes) &&
+        (id == nd ||
+         ieee_order(id, FPC::Native32RealDescriptor()) != IEEEOrder::none ||
+         ieee_order(id, FPC::Native64RealDescriptor()) != IEEEOrder::none);
+
+    Vector<char> bufr;
+    if (!in_place) {
+        bufr.resize(std::min(buffSize, nitems) * ibytes);
+    }
+
+    while (nitems > 0)
+    {
+        Long get = std::min(buffSize, nitems);
+        char* src = in_place ? reinterpret_cast<char*>(out) + get*(obytes-ibytes)
+                             : bufr.data();
+        is.read(src, ibytes*get);
+        PD_convert(out,
+                   src,
+                   get,
+                   0,
+                   nd,
+                   id,
+                   FPC::NativeLongDescriptor());
+
+        if(fix_denormals) {
+          PD_fixdenormals(out, get, nd.format(), nd.order());
+        }
+        nitems -= get;
+        out    += get;
+    }
+
+    if(is.fail()) {
+      amrex::Error("convert(Real*,Long,istream&,RealDescriptor&) failed");
+    }
+}
+
 //
 // Convert nitems in RealDescriptor format to native Real format.
 //
@@ -994,34 +1209,8 @@ RealDescriptor::convertToNativeFormat (Real*                 out,
 {
 //    BL_PROFILE("RD:convertToNativeFormat_is");
 
-    Long buffSize(std::min(Long(readBufferSize), nitems));
-    char *bufr = new char[buffSize * id.numBytes()];
-
-    while (nitems > 0)
-    {
-        Long get = std::min(static_cast<Long>(readBufferSize), nitems);
-        is.read(bufr, id.numBytes()*get);
-        PD_convert(out,
-                   bufr,
-                   get,
-                   0,
-                   FPC::NativeRealDescriptor(),
-                   id,
-                   FPC::NativeLongDescriptor());
-
-        if(bAlwaysFixDenormals) {
-          PD_fixdenormals(out, get, FPC::NativeRealDescriptor().format(),
-                          FPC::NativeRealDescriptor().order());
-        }
-        nitems -= get;
-        out    += get;
-    }
-
-    if(is.fail()) {
-      amrex::Error("convert(Real*,Long,istream&,RealDescriptor&) failed");
-    }
-
-    delete [] bufr;
+    PD_read_convert(out, nitems, is, id, FPC::NativeRealDescriptor(),
+                    readBufferSize, bAlwaysFixDenormals);
 }
 
 //
@@ -1182,34 +1371,8 @@ RealDescriptor::convertToNativeFloatFormat (float*                out,
 {
 //    BL_PROFILE("RD:convertToNativeFloatFormat");
 
-    Long buffSize(std::min(Long(readBufferSize), nitems));
-    char *bufr = new char[buffSize * id.numBytes()];
-
-    while (nitems > 0)
-    {
-        Long get = std::min(static_cast<Long>(readBufferSize), nitems);
-        is.read(bufr, id.numBytes()*get);
-        PD_convert(out,
-                   bufr,
-                   get,
-                   0,
-                   FPC::Native32RealDescriptor(),
-                   id,
-                   FPC::NativeLongDescriptor());
-
-        if(bAlwaysFixDenormals) {
-          PD_fixdenormals(out, get, FPC::Native32RealDescriptor().format(),
-                          FPC::Native32RealDescriptor().order());
-        }
-        nitems -= get;
-        out    += get;
-    }
-
-    if(is.fail()) {
-      amrex::Error("convert(Real*,Long,istream&,RealDescriptor&) failed");
-    }
-
-    delete [] bufr;
+    PD_read_convert(out, nitems, is, id, FPC::Native32RealDescriptor(),
+                    readBufferSize, bAlwaysFixDenormals);
 }
 
 //
@@ -1224,34 +1387,8 @@ RealDescriptor::convertToNativeDoubleFormat (double*               out,
 {
 //    BL_PROFILE("RD:convertToNativeDoubleFormat");
 
-    Long buffSize(std::min(Long(readBufferSize), nitems));
-    char *bufr = new char[buffSize * id.numBytes()];
-
-    while (nitems > 0)
-    {
-        Long get = std::min(static_cast<Long>(readBufferSize), nitems);
-        is.read(bufr, id.numBytes()*get);
-        PD_convert(out,
-                   bufr,
-                   get,
-                   0,
-                   FPC::Native64RealDescriptor(),
-                   id,
-                   FPC::NativeLongDescriptor());
-
-        if(bAlwaysFixDenormals) {
-          PD_fixdenormals(out, get, FPC::Native64RealDescriptor().format(),
-                          FPC::Native64RealDescriptor().order());
-        }
-        nitems -= get;
-        out    += get;
-    }
-
-    if(is.fail()) {
-      amrex::Error("convert(Real*,Long,istream&,RealDescriptor&) failed");
-    }
-
-    delete [] bufr;
+    PD_read_convert(out, nitems, is, id, FPC::Native64RealDescriptor(),
+                    readBufferSize, bAlwaysFixDenormals);
 }
 
 }
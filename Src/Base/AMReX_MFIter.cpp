@@ -3,6 +3,9 @@
 #include <AMReX_FabArray.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_OpenMP.H>
+#ifdef AMREX_TINY_PROFILING
+#include <AMReX_TinyProfiler.H>
+#endif
 
 namespace amrex {
 
@@ -209,6 +212,10 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
 
 MFIter::~MFIter ()
 {
+#ifdef AMREX_TINY_PROFILING
+    TinyProfiler::SetTraceBox(-1);
+#endif
+
 #ifdef AMREX_USE_OMP
 #pragma omp master
 #endif
@@ -348,6 +355,12 @@ MFIter::Initialize ()
 
         typ = fabArray.boxArray().ixType();
     }
+
+#ifdef AMREX_TINY_PROFILING
+    if (TinyProfiler::Tracing() && isValid()) {
+        TinyProfiler::SetTraceBox(index());
+    }
+#endif
 }
 
 Box
@@ -511,6 +524,12 @@ MFIter::operator++ () noexcept
         }
 #endif
     }
+
+#ifdef AMREX_TINY_PROFILING
+    if (TinyProfiler::Tracing() && isValid()) {
+        TinyProfiler::SetTraceBox(index());
+    }
+#endif
 }
 
 }
@@ -1,15 +1,26 @@
 
 #include <AMReX_MemProfiler.H>
 #include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
 #include <AMReX.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#ifdef AMREX_TINY_PROFILING
+#include <AMReX_TinyProfiler.H>
+#endif
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
 #include <limits>
 #include <numeric>
 #include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 
 #ifdef __linux__
 #include <unistd.h>
@@ -21,6 +32,276 @@ namespace amrex {
 
 std::unique_ptr<MemProfiler> MemProfiler::the_instance = nullptr;
 
+namespace {
+
+const std::string& memoryLogName ()
+{
+    static std::string memory_log_name;
+    if (memory_log_name.empty()) {
+        memory_log_name = "memlog";
+        ParmParse pp("amrex");
+        pp.queryAdd("memory_log", memory_log_name);
+    }
+    return memory_log_name;
+}
+
+thread_local const char* current_owner = nullptr;
+
+//
+// Live arena allocations, attributed to (owner, call path) keys.  The
+// allocation and free paths do not take a global lock.  The live pointers
+// are split into shards with their own locks, the byte counts are atomic,
+// and each thread caches the counters of the keys it has seen.  The global
+// mutex is only taken for a new key, to record the breakdown at a new peak
+// (after growth of more than 1/64), and to coarsen the timeline.  Because
+// the threads update the counters independently, the breakdown at the peak
+// and the timeline are approximate when several threads allocate at once.
+//
+struct MemTracker
+{
+    static constexpr int nshards = 64;
+    static constexpr int max_timeline = 8192;
+
+    std::atomic<bool> on{false};
+    std::atomic<int> generation{0};   //!< invalidates the key caches of the threads
+    std::mutex mutex;
+
+    struct Alloc {
+        Long bytes;
+        std::atomic<Long>* key_bytes;
+    };
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<void*,Alloc> live;
+    };
+    Shard shards[nshards];
+
+    std::map<std::pair<std::string,std::vector<int> >,int> keyids;
+    std::vector<std::pair<std::string,std::vector<int> > > keys;
+    std::deque<std::atomic<Long> > key_bytes; //!< current bytes of each key; elements never move
+    std::vector<Long> peak_key_bytes;         //!< key_bytes when the peak was last recorded
+
+    std::atomic<Long> cur{0};
+    std::atomic<Long> peak{0};
+    std::atomic<Long> snap{0};                //!< total when peak_key_bytes was recorded
+
+    double t0 = 0.0;
+    std::atomic<double> interval{1.0};
+    std::atomic<Long> timeline[max_timeline]; //!< high water mark in each interval, -1 if none
+    std::atomic<int> ntimeline{0};
+
+    MemTracker () { reset(); }
+
+    //! Must not be called while other threads allocate.
+    void reset ()
+    {
+        for (auto& s : shards) { s.live.clear(); }
+        keyids.clear();
+        keys.clear();
+        key_bytes.clear();
+        peak_key_bytes.clear();
+        cur = 0;
+        peak = 0;
+        snap = 0;
+        for (auto& x : timeline) { x = -1; }
+        ntimeline = 0;
+        ++generation;
+    }
+
+    Shard& shard (void* p)
+    {
+        auto h = reinterpret_cast<std::uintptr_t>(p) >> 4;
+        h ^= h >> 7;
+        return shards[h % nshards];
+    }
+
+    std::atomic<Long>* newKey (const char* owner, std::vector<int> const& path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto r = keyids.emplace(std::make_pair(std::string(owner), path),
+                                static_cast<int>(keys.size()));
+        if (r.second) {
+            keys.push_back(r.first->first);
+            key_bytes.emplace_back(0);
+        }
+        return &key_bytes[r.first->second];
+    }
+
+    static void atomicMax (std::atomic<Long>& a, Long v)
+    {
+        Long old = a.load(std::memory_order_relaxed);
+        while (v > old && !a.compare_exchange_weak(old, v, std::memory_order_relaxed)) {}
+    }
+
+    void updatePeak (Long now)
+    {
+        const Long old = peak.load(std::memory_order_relaxed);
+        if (now <= old) { return; }
+        atomicMax(peak, now);
+        // Copying the breakdown on every new peak would be too expensive
+        // while memory is growing.
+        const Long s = snap.load(std::memory_order_relaxed);
+        if (now - s > s/64) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (now - snap > snap/64) {
+                peak_key_bytes.resize(key_bytes.size());
+                for (std::size_t k = 0; k < key_bytes.size(); ++k) {
+                    peak_key_bytes[k] = key_bytes[k].load(std::memory_order_relaxed);
+                }
+                snap = now;
+            }
+        }
+    }
+
+    void sample (Long now)
+    {
+        const double dt = amrex::second() - t0;
+        auto b = static_cast<int>(dt / interval.load(std::memory_order_relaxed));
+        if (b >= max_timeline) {
+            std::lock_guard<std::mutex> lock(mutex);
+            while ((b = static_cast<int>(dt / interval)) >= max_timeline) {
+                // Halve the resolution to bound the memory used by the timeline.
+                const int n = ntimeline;
+                for (int i = 0; i < (n+1)/2; ++i) {
+                    const Long a = timeline[2*i].load();
+                    const Long c = (2*i+1 < n) ? timeline[2*i+1].load() : Long(-1);
+                    timeline[i] = std::max(a, c);
+                }
+                for (int i = (n+1)/2; i < n; ++i) { timeline[i] = -1; }
+                ntimeline = (n+1)/2;
+                interval = 2.0*interval;
+            }
+        }
+        atomicMax(timeline[b], now);
+        int n = ntimeline.load(std::memory_order_relaxed);
+        while (b >= n && !ntimeline.compare_exchange_weak(n, b+1, std::memory_order_relaxed)) {}
+    }
+};
+
+MemTracker& memTracker ()
+{
+    static MemTracker t;
+    return t;
+}
+
+//! Counters of the keys seen by a thread, found without allocating.
+struct KeyCache
+{
+    struct Entry {
+        const char* owner;
+        std::vector<int> path;
+        std::atomic<Long>* key_bytes;
+    };
+    std::unordered_map<std::uint64_t,std::vector<Entry> > entries;
+    std::vector<int> path;   //!< scratch
+    int generation = -1;
+
+    std::atomic<Long>* get (MemTracker& t, const char* owner)
+    {
+        const int gen = t.generation.load(std::memory_order_relaxed);
+        if (gen != generation) {
+            entries.clear();
+            generation = gen;
+        }
+        path.clear();
+#ifdef AMREX_TINY_PROFILING
+        TinyProfiler::GetCallPath(path);
+#endif
+        // FNV-1a of the owner and the call path
+        std::uint64_t h = 14695981039346656037ULL;
+        auto mix = [&h] (std::uint64_t v) { h ^= v; h *= 1099511628211ULL; };
+        mix(reinterpret_cast<std::uintptr_t>(owner));
+        for (int id : path) { mix(static_cast<std::uint64_t>(id)); }
+
+        auto& bucket = entries[h];
+        for (auto const& e : bucket) {
+            if (e.owner == owner && e.path == path) { return e.key_bytes; }
+        }
+        bucket.push_back(Entry{owner, path, t.newKey(owner, path)});
+        return bucket.back().key_bytes;
+    }
+};
+
+}
+
+MemProfiler::Owner::Owner (const char* name) noexcept
+    : m_prev(current_owner)
+{
+    current_owner = name;
+}
+
+MemProfiler::Owner::~Owner ()
+{
+    current_owner = m_prev;
+}
+
+void
+MemProfiler::StartTracking ()
+{
+    bool tracking = false;
+    double interval = 1.0;
+    {
+        ParmParse pp("amrex");
+        pp.queryAdd("memory_tracking", tracking);
+        pp.queryAdd("memory_timeline_interval", interval);
+    }
+    MemTracker& t = memTracker();
+    t.on = false;
+    t.reset();
+    t.interval = std::max(interval, 1.e-3);
+    t.t0 = amrex::second();
+    t.on = tracking;
+}
+
+void
+MemProfiler::TrackAlloc (void* p, std::size_t nbytes)
+{
+    MemTracker& t = memTracker();
+    if (!t.on.load(std::memory_order_relaxed) || p == nullptr) { return; }
+
+    static thread_local KeyCache key_cache;
+    std::atomic<Long>* key_bytes
+        = key_cache.get(t, (current_owner != nullptr) ? current_owner : "Other");
+
+    const auto n = static_cast<Long>(nbytes);
+    {
+        auto& s = t.shard(p);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.live[p] = MemTracker::Alloc{n, key_bytes};
+    }
+    key_bytes->fetch_add(n, std::memory_order_relaxed);
+    const Long now = t.cur.fetch_add(n, std::memory_order_relaxed) + n;
+    t.updatePeak(now);
+    t.sample(now);
+}
+
+void
+MemProfiler::TrackFree (void* p)
+{
+    MemTracker& t = memTracker();
+    if (!t.on.load(std::memory_order_relaxed) || p == nullptr) { return; }
+
+    MemTracker::Alloc a;
+    {
+        auto& s = t.shard(p);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.live.find(p);
+        if (it == s.live.end()) { return; } // allocated before tracking started
+        a = it->second;
+        s.live.erase(it);
+    }
+    a.key_bytes->fetch_sub(a.bytes, std::memory_order_relaxed);
+    // The high water mark of this interval includes the memory just freed.
+    t.sample(t.cur.fetch_sub(a.bytes, std::memory_order_relaxed));
+}
+
+MemProfiler::MemInfo
+MemProfiler::TrackedMemInfo ()
+{
+    MemTracker& t = memTracker();
+    return MemInfo{t.cur.load(), t.peak.load()};
+}
+
 void
 MemProfiler::add (const std::string& name, std::function<MemInfo()>&& f)
 {
@@ -59,20 +340,138 @@ MemProfiler::getInstance ()
 void
 MemProfiler::Finalize ()
 {
+    if (memTracker().on) {
+        reportTracking(memoryLogName());
+        memTracker().on = false;
+    }
     the_instance.reset();
 }
 
 void
 MemProfiler::report (const std::string& prefix)
 {
-    static std::string memory_log_name;
-    if (memory_log_name.empty()) {
-        memory_log_name = "memlog";
-        ParmParse pp("amrex");
-        pp.queryAdd("memory_log", memory_log_name);
+    getInstance().report_(prefix, memoryLogName());
+}
+
+void
+MemProfiler::reportTracking (const std::string& memory_log_name)
+{
+    MemTracker& t = memTracker();
+    t.sample(t.cur.load());
+    std::vector<Long> timeline;
+    std::vector<std::pair<std::string,std::vector<int> > > keys;
+    std::vector<Long> peak_key_bytes;
+    Long peak;
+    double interval;
+    {
+        std::lock_guard<std::mutex> lock(t.mutex);
+        // Intervals without any allocation or free keep the previous mark.
+        timeline.resize(t.ntimeline);
+        for (std::size_t i = 0; i < timeline.size(); ++i) {
+            const Long v = t.timeline[i];
+            timeline[i] = (v >= 0 || i == 0) ? std::max(v, Long(0)) : timeline[i-1];
+        }
+        keys = t.keys;
+        peak_key_bytes = t.peak_key_bytes;
+        peak_key_bytes.resize(keys.size(), 0);
+        peak = t.peak;
+        interval = t.interval;
     }
 
-    getInstance().report_(prefix, memory_log_name);
+    const int IOProc = ParallelDescriptor::IOProcessorNumber();
+
+    //
+    // The timeline: bring all processes to the coarsest resolution and length.
+    //
+    double max_interval = interval;
+    ParallelAllReduce::Max(max_interval, ParallelDescriptor::Communicator());
+    while (interval < 0.5*max_interval) {
+        for (std::size_t i = 0; i < timeline.size()/2; ++i) {
+            timeline[i] = std::max(timeline[2*i], timeline[2*i+1]);
+        }
+        if (timeline.size() % 2 != 0) {
+            timeline[timeline.size()/2] = timeline.back();
+        }
+        timeline.resize((timeline.size()+1)/2);
+        interval *= 2.0;
+    }
+    int nt = static_cast<int>(timeline.size());
+    ParallelDescriptor::ReduceIntMax(nt);
+    timeline.resize(nt, timeline.empty() ? 0L : timeline.back());
+    std::vector<Long> tl_max = timeline;
+    std::vector<Long> tl_sum = timeline;
+    if (nt > 0) {
+        ParallelDescriptor::ReduceLongMax(tl_max.data(), nt, IOProc);
+        ParallelDescriptor::ReduceLongSum(tl_sum.data(), nt, IOProc);
+    }
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream tlog(memory_log_name+".timeline", std::ofstream::out|std::ofstream::trunc);
+        if (tlog.good()) {
+            tlog << "# Tracked arena memory; high water mark in each interval of "
+                 << interval << " s\n"
+                 << "# time (s)    max over processes (B)    sum over processes (B)\n";
+            for (int i = 0; i < nt; ++i) {
+                tlog << i*interval << " " << tl_max[i] << " " << tl_sum[i] << "\n";
+            }
+        }
+    }
+
+    //
+    // The process with the highest peak reports its breakdown after the
+    // I/O process has written the timeline.
+    //
+    Long max_peak = peak;
+    ParallelDescriptor::ReduceLongMax(max_peak);
+    int peak_proc = (peak == max_peak) ? ParallelDescriptor::MyProc()
+                                       : ParallelDescriptor::NProcs();
+    ParallelDescriptor::ReduceIntMin(peak_proc);
+    ParallelDescriptor::Barrier();
+
+    if (ParallelDescriptor::MyProc() != peak_proc) { return; }
+
+    std::ofstream memlog(memory_log_name.c_str(), std::ofstream::out|std::ofstream::app);
+    if (!memlog.good()) { return; }
+
+    auto in_MB = [] (Long b) { return static_cast<double>(b) / (1024.*1024.); };
+
+    memlog << "Peak Tracked Arena Memory: " << in_MB(peak) << " MB on process "
+           << peak_proc << "\n";
+
+    std::map<std::string,Long> by_owner;
+    for (std::size_t k = 0; k < keys.size(); ++k) {
+        by_owner[keys[k].first] += peak_key_bytes[k];
+    }
+    std::vector<std::pair<std::string,Long> > owners(by_owner.begin(), by_owner.end());
+    std::sort(owners.begin(), owners.end(),
+              [] (auto const& a, auto const& b) { return a.second > b.second; });
+    memlog << "  By owner:\n";
+    for (auto const& o : owners) {
+        if (o.second > 0) {
+            memlog << "    " << std::setw(16) << std::left << o.first << std::right
+                   << std::setw(12) << std::fixed << std::setprecision(2)
+                   << in_MB(o.second) << " MB\n";
+        }
+    }
+
+    std::vector<std::size_t> idx(keys.size());
+    std::iota(idx.begin(), idx.end(), std::size_t(0));
+    std::sort(idx.begin(), idx.end(), [&] (std::size_t i, std::size_t j)
+              { return peak_key_bytes[i] > peak_key_bytes[j]; });
+    memlog << "  By owner and call path:\n";
+    const std::size_t nshow = std::min(idx.size(), std::size_t(20));
+    for (std::size_t i = 0; i < nshow && peak_key_bytes[idx[i]] > 0; ++i) {
+        auto const& k = keys[idx[i]];
+        memlog << "    " << std::setw(12) << std::fixed << std::setprecision(2)
+               << in_MB(peak_key_bytes[idx[i]]) << " MB  " << k.first << "  ";
+#ifdef AMREX_TINY_PROFILING
+        memlog << TinyProfiler::CallPathName(k.second);
+#else
+        memlog << "(call paths require tiny profiling)";
+#endif
+        memlog << "\n";
+    }
+    memlog << std::endl;
 }
 
 void
@@ -252,7 +651,7 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
         std::sort(idxs.begin(), idxs.end(), [&](int i, int j)
                   { return hwm_max[i] > hwm_max[j]; });
 
-        for (int ii = 0; ii < idxs.size(); ++ii) {
+        for (int ii = 0; ii < static_cast<int>(idxs.size()); ++ii) {
             int i = idxs[ii];
             if (hwm_max[i] > 0) {
                 memlog << ident;
@@ -282,7 +681,7 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
             memlog << ident;
             memlog << "|-" << dash_name << "-+-" << dash_bytes << "-+-" << dash_bytes << "-|\n";
 
-            for (int i = 0; i < the_names_builds.size(); ++i) {
+            for (int i = 0; i < static_cast<int>(the_names_builds.size()); ++i) {
                 if (hwm_builds_max[i] > 0) {
                     memlog << ident;
                     memlog << "| " << std::setw(width_name) << std::left << the_names_builds[i] << " | ";
@@ -7,6 +7,7 @@ namespace amrex {
 
 int NFilesIter::currentDeciderIndex(-1);
 int NFilesIter::minDigits(5);
+NFilesIter::WriteStats NFilesIter::writeStats;
 
 
 NFilesIter::NFilesIter(int noutfiles, const std::string &fileprefix,
@@ -205,6 +206,23 @@ NFilesIter::~NFilesIter() {
 
 bool NFilesIter::ReadyToWrite(bool appendFirst) {
 
+  if(finishedWriting) {
+    return false;
+  }
+
+  double waitStartTime(amrex::second());
+  bool ready(WaitForTurn(appendFirst));
+  if(ready) {
+    writeStartTime = amrex::second();
+    writeStartPos  = fileStream.tellp();
+    writeStats.waitTime += writeStartTime - waitStartTime;
+  }
+  return ready;
+}
+
+
+bool NFilesIter::WaitForTurn(bool appendFirst) {
+
 #ifdef BL_USE_MPI
 
   if(finishedWriting) {
@@ -346,6 +364,16 @@ bool NFilesIter::ReadyToRead() {
 
 NFilesIter &NFilesIter::operator++() {
 
+  if( ! isReading && fileStream.is_open()) {
+    fileStream.flush();
+    std::streampos endPos(fileStream.tellp());
+    if(endPos > writeStartPos) {
+      writeStats.nBytes += static_cast<Long>(endPos - writeStartPos);
+    }
+    writeStats.writeTime += amrex::second() - writeStartTime;
+    ++writeStats.nWrites;
+  }
+
 #ifdef BL_USE_MPI
 
   ParallelDescriptor::Message rmess;
@@ -61,6 +61,9 @@ void PrepareCommBuffers(CommData& comm,
     }
     else
     {
+#ifdef AMREX_MEM_PROFILING
+        MemProfiler::Owner mem_owner("CommBuffer");
+#endif
         comm.the_data.reset(static_cast<char*>(amrex::The_FA_Arena()->alloc(total_volume)));
         for (int i = 0; i < N_comms; ++i) {
             comm.data[i] = comm.the_data.get() + comm.offset[i];
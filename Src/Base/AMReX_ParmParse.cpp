@@ -19,9 +19,13 @@
 #include <cctype>
 #include <vector>
 #include <list>
+#include <mutex>
 #include <regex>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 
 extern "C" void amrex_init_namelist (const char*);
 extern "C" void amrex_finalize_namelist ();
@@ -194,6 +198,77 @@ is (const std::string& str, bool& val)
     return false;
 }
 
+//
+// Converting a string to a number with an istringstream is slow, and the
+// same values are queried over and over during setup.  The results for
+// arithmetic types are therefore cached by the string content.  There is a
+// cache for each type; Finalize clears them all.
+//
+
+namespace {
+
+std::mutex g_cache_mutex;
+
+std::vector<void(*)()>&
+cache_clear_functions ()
+{
+    static std::vector<void(*)()> r;
+    return r;
+}
+
+template <class T>
+struct ValueCache
+{
+    static std::unordered_map<std::string,std::pair<bool,T> >& get ()
+    {
+        static std::unordered_map<std::string,std::pair<bool,T> > cache;
+        return cache;
+    }
+    static void clear () { get().clear(); }
+};
+
+}
+
+template <class T>
+bool
+is_cached (const std::string& str, T& val, std::false_type)
+{
+    return is(str, val);
+}
+
+template <class T>
+bool
+is_cached (const std::string& str, T& val, std::true_type)
+{
+    static bool registered = false;
+    std::lock_guard<std::mutex> lock(g_cache_mutex);
+    if ( !registered )
+    {
+        cache_clear_functions().push_back(&ValueCache<T>::clear);
+        registered = true;
+    }
+    auto& cache = ValueCache<T>::get();
+    auto it = cache.find(str);
+    if ( it == cache.end() )
+    {
+        T v{};
+        bool ok = is(str, v);
+        it = cache.emplace(str, std::make_pair(ok, v)).first;
+    }
+    if ( it->second.first )
+    {
+        val = it->second.second;
+    }
+    return it->second.first;
+}
+
+template <class T>
+bool
+is_cached (const std::string& str, T& val)
+{
+    return is_cached(str, val, std::is_arithmetic<T>());
+}
+
 ParmParse::Table g_table;
 typedef std::list<ParmParse::PP_entry>::iterator list_iterator;
 typedef std::list<ParmParse::PP_entry>::const_iterator const_list_iterator;
@@ -396,6 +471,66 @@ ppfound (const std::string& keyword,
     return (recordQ == (pe.m_table!=0)) && (keyword == pe.m_name);
 }
 
+//
+// Hash index of g_table from the fully prefixed name to its entries in
+// table order.  The table only grows at its end, except in remove and
+// Finalize, so the index is extended lazily on lookup and is thrown away
+// whenever entries are erased.  All lookups hold g_pp_mutex, which makes
+// queries safe to call from OpenMP regions.
+//
+
+namespace {
+
+std::mutex g_pp_mutex;
+
+struct PPIndex
+{
+    using Entries = std::vector<const ParmParse::PP_entry*>;
+
+    std::unordered_map<std::string,Entries> m_defs;
+    std::unordered_map<std::string,Entries> m_records;
+    std::size_t                             m_count = 0;
+    const_list_iterator                     m_last;
+
+    void clear ()
+    {
+        m_defs.clear();
+        m_records.clear();
+        m_count = 0;
+    }
+
+    void update (const ParmParse::Table& table)
+    {
+        if ( table.size() < m_count )
+        {
+            clear();
+        }
+        if ( table.size() == m_count )
+        {
+            return;
+        }
+        const_list_iterator li = (m_count == 0) ? table.begin() : std::next(m_last);
+        for ( const_list_iterator End = table.end(); li != End; ++li )
+        {
+            auto& m = (li->m_table != 0) ? m_records : m_defs;
+            m[li->m_name].push_back(&*li);
+            m_last = li;
+        }
+        m_count = table.size();
+    }
+
+    const Entries* find (const std::string& name, bool recordQ) const
+    {
+        auto const& m = recordQ ? m_records : m_defs;
+        auto it = m.find(name);
+        return (it == m.end()) ? nullptr : &(it->second);
+    }
+};
+
+PPIndex g_index;
+
+}
+
 //
 // Return the index of the n'th occurrence of a parameter name,
 // except if n==-1, return the index of the last occurrence.
@@ -408,6 +543,35 @@ ppindex (const ParmParse::Table& table,
          const std::string& name,
          bool recordQ)
 {
+    std::lock_guard<std::mutex> lock(g_pp_mutex);
+
+    if ( &table == &g_table )
+    {
+        g_index.update(table);
+        const PPIndex::Entries* entries = g_index.find(name, recordQ);
+        if ( entries == nullptr )
+        {
+            return 0;
+        }
+        const ParmParse::PP_entry* fnd = 0;
+        if ( n == ParmParse::LAST )
+        {
+            fnd = entries->back();
+        }
+        else if ( n < static_cast<int>(entries->size()) )
+        {
+            fnd = (*entries)[n];
+        }
+        if ( fnd )
+        {
+            for (auto const* pe : *entries)
+            {
+                pe->m_queried = true;
+            }
+        }
+        return fnd;
+    }
+
     const ParmParse::PP_entry* fnd = 0;
 
     if ( n == ParmParse::LAST )
@@ -459,6 +623,36 @@ ppindex (const ParmParse::Table& table,
     return fnd;
 }
 
+//
+// Return the number of occurrences of a parameter name.
+//
+
+static
+int
+ppcount (const ParmParse::Table& table,
+         const std::string& name,
+         bool recordQ)
+{
+    std::lock_guard<std::mutex> lock(g_pp_mutex);
+
+    if ( &table == &g_table )
+    {
+        g_index.update(table);
+        const PPIndex::Entries* entries = g_index.find(name, recordQ);
+        return (entries == nullptr) ? 0 : static_cast<int>(entries->size());
+    }
+
+    int cnt = 0;
+    for ( const_list_iterator li = table.begin(), End = table.end(); li != End; ++li )
+    {
+        if ( ppfound(name, *li, recordQ) )
+        {
+            cnt++;
+        }
+    }
+    return cnt;
+}
+
 void
 bldTable (const char*& str, std::list<ParmParse::PP_entry>& tab);
 
@@ -754,7 +948,7 @@ squeryval (const ParmParse::Table& table,
 
     const std::string& valname = def->m_vals[ival];
 
-    bool ok = is(valname, ptr);
+    bool ok = is_cached(valname, ptr);
     if ( !ok )
     {
         amrex::ErrorStream() << "ParmParse::queryval type mismatch on value number "
@@ -855,7 +1049,7 @@ squeryarr (const ParmParse::Table& table,
     for ( int n = start_ix; n <= stop_ix; n++ )
     {
         const std::string& valname = def->m_vals[n];
-        bool ok = is(valname, ptr[n]);
+        bool ok = is_cached(valname, ptr[n]);
         if ( !ok )
         {
             amrex::ErrorStream() << "ParmParse::queryarr type mismatch on value number "
@@ -914,6 +1108,7 @@ saddval (const std::string&      name,
     val << std::setprecision(17) << ptr;
     ParmParse::PP_entry entry(name,val.str());
     entry.m_queried=true;
+    std::lock_guard<std::mutex> lock(g_pp_mutex);
     g_table.push_back(entry);
 }
 
@@ -931,6 +1126,7 @@ saddarr (const std::string&      name,
     }
     ParmParse::PP_entry entry(name,arr);
     entry.m_queried=true;
+    std::lock_guard<std::mutex> lock(g_pp_mutex);
     g_table.push_back(entry);
 }
 
@@ -991,6 +1187,7 @@ ParmParse::prefixedName (const std::string& str) const
 void
 ParmParse::addfile (std::string const filename) {
     auto l = std::list<std::string>{filename};
+    std::lock_guard<std::mutex> lock(g_pp_mutex);
     addDefn(FileKeyword,
             l,
             g_table);
@@ -1081,6 +1278,7 @@ ParmParse::Frame::getPrefix () const
 void
 ParmParse::appendTable(ParmParse::Table& tab)
 {
+  std::lock_guard<std::mutex> lock(g_pp_mutex);
   g_table.splice(g_table.end(), tab);
 }
 
@@ -1245,6 +1443,13 @@ ParmParse::Finalize ()
       if (amrex::system::abort_on_unused_inputs) amrex::Abort("ERROR: unused ParmParse variables.");
     }
     g_table.clear();
+    g_index.clear();
+    {
+        std::lock_guard<std::mutex> lock(g_cache_mutex);
+        for (auto f : cache_clear_functions()) {
+            f();
+        }
+    }
 
 #if !defined(BL_NO_FORT)
     amrex_finalize_namelist();
@@ -2030,29 +2235,13 @@ ParmParse::addarr (const char* name,
 int
 ParmParse::countname (const std::string& name) const
 {
-    int cnt = 0;
-    for ( const_list_iterator li = m_table.begin(), End = m_table.end(); li != End; ++li )
-    {
-        if ( ppfound(prefixedName(name), *li, false) )
-        {
-            cnt++;
-        }
-    }
-    return cnt;
+    return ppcount(m_table, prefixedName(name), false);
 }
 
 int
 ParmParse::countRecords (const std::string& name) const
 {
-    int cnt = 0;
-    for ( const_list_iterator li = m_table.begin(), End = m_table.end(); li != End; ++li )
-    {
-        if ( ppfound(prefixedName(name), *li, true) )
-        {
-            cnt++;
-        }
-    }
-    return cnt;
+    return ppcount(m_table, prefixedName(name), true);
 }
 
 //
@@ -2062,29 +2251,19 @@ ParmParse::countRecords (const std::string& name) const
 bool
 ParmParse::contains (const char* name) const
 {
-    for ( const_list_iterator li = m_table.begin(), End = m_table.end(); li != End; ++li )
-    {
-       if ( ppfound(prefixedName(name), *li, false))
-       {
-           //
-           // Found an entry; mark all occurrences of name as used.
-           //
-           for ( const_list_iterator lli = m_table.begin(); lli != m_table.end(); ++lli )
-           {
-               if ( ppfound(prefixedName(name), *lli, false) )
-               {
-                   lli->m_queried = true;
-               }
-           }
-           return true;
-       }
-    }
-    return false;
+    //
+    // Marks all occurrences of name as used.
+    //
+    return ppindex(m_table, LAST, prefixedName(name), false) != 0;
 }
 
 int
 ParmParse::remove (const char* name)
 {
+    std::lock_guard<std::mutex> lock(g_pp_mutex);
+    if (&m_table == &g_table) {
+        g_index.clear();
+    }
     int r = 0;
     for (auto it = m_table.begin(); it != m_table.end(); ) {
         if (ppfound(prefixedName(name), *it, false)) {
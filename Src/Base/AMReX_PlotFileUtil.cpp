@@ -167,6 +167,13 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
                          const std::string &mfPrefix,
                          const Vector<std::string>& extra_dirs)
 {
+    if (AsyncOut::UseAsyncOut()) {
+        WriteMultiLevelPlotfileAsync(plotfilename, nlevels, mf, varnames, geom, time,
+                                     level_steps, ref_ratio, versionName, levelPrefix,
+                                     mfPrefix, extra_dirs);
+        return;
+    }
+
     BL_PROFILE("WriteMultiLevelPlotfile()");
 
     BL_ASSERT(nlevels <= mf.size());
@@ -193,7 +200,91 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
             boxArrays[level] = mf[level]->boxArray();
         }
 
-        auto f = [=]() {
+        VisMF::IO_Buffer io_buffer(VisMF::IO_Buffer_Size);
+        std::string HeaderFileName(plotfilename + "/Header");
+        std::ofstream HeaderFile;
+        HeaderFile.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+        HeaderFile.open(HeaderFileName.c_str(), std::ofstream::out   |
+                                                std::ofstream::trunc |
+                                                std::ofstream::binary);
+        if( ! HeaderFile.good()) FileOpenFailed(HeaderFileName);
+        WriteGenericPlotfileHeader(HeaderFile, nlevels, boxArrays, varnames,
+                                   geom, time, level_steps, ref_ratio, versionName,
+                                   levelPrefix, mfPrefix);
+    }
+
+    for (int level = 0; level <= finest_level; ++level)
+    {
+        const MultiFab* data;
+        std::unique_ptr<MultiFab> mf_tmp;
+        if (mf[level]->nGrowVect() != 0) {
+            mf_tmp = std::make_unique<MultiFab>(mf[level]->boxArray(),
+                                                mf[level]->DistributionMap(),
+                                                mf[level]->nComp(), 0, MFInfo(),
+                                                mf[level]->Factory());
+            MultiFab::Copy(*mf_tmp, *mf[level], 0, 0, mf[level]->nComp(), 0);
+            data = mf_tmp.get();
+        } else {
+            data = mf[level];
+        }
+        VisMF::Write(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix));
+    }
+}
+
+AsyncOut::WriteHandle
+WriteMultiLevelPlotfileAsync (const std::string& plotfilename, int nlevels,
+                              const Vector<const MultiFab*>& mf,
+                              const Vector<std::string>& varnames,
+                              const Vector<Geometry>& geom, Real time,
+                              const Vector<int>& level_steps,
+                              const Vector<IntVect>& ref_ratio,
+                              const std::string &versionName,
+                              const std::string &levelPrefix,
+                              const std::string &mfPrefix,
+                              const Vector<std::string>& extra_dirs)
+{
+    if (!AsyncOut::UseAsyncOut()) {
+        WriteMultiLevelPlotfile(plotfilename, nlevels, mf, varnames, geom, time,
+                                level_steps, ref_ratio, versionName, levelPrefix,
+                                mfPrefix, extra_dirs);
+        return AsyncOut::WriteHandle();
+    }
+
+    BL_PROFILE("WriteMultiLevelPlotfileAsync()");
+
+    BL_ASSERT(nlevels <= mf.size());
+    BL_ASSERT(nlevels <= geom.size());
+    BL_ASSERT(nlevels <= ref_ratio.size()+1);
+    BL_ASSERT(nlevels <= level_steps.size());
+    BL_ASSERT(mf[0]->nComp() == varnames.size());
+
+    bool callBarrier(false);
+    PreBuildDirectorHierarchy(plotfilename, levelPrefix, nlevels, callBarrier);
+    if (!extra_dirs.empty()) {
+        for (const auto& d : extra_dirs) {
+            const std::string ed = plotfilename+"/"+d;
+            amrex::PreBuildDirectorHierarchy(ed, levelPrefix, nlevels, callBarrier);
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    // Levels are staged one at a time.  If the staging pool is full,
+    // AsyncWrite blocks until earlier levels have been written.
+    for (int level = 0; level < nlevels; ++level) {
+        VisMF::AsyncWrite(*mf[level],
+                          MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix),
+                          true);
+    }
+
+    // The plotfile Header is queued after all the level data, so its
+    // presence on disk means the plotfile is complete.
+    if (ParallelDescriptor::MyProc() == ParallelDescriptor::NProcs()-1) {
+        Vector<BoxArray> boxArrays(nlevels);
+        for(int level(0); level < boxArrays.size(); ++level) {
+            boxArrays[level] = mf[level]->boxArray();
+        }
+
+        AsyncOut::Submit([=]() {
             VisMF::IO_Buffer io_buffer(VisMF::IO_Buffer_Size);
             std::string HeaderFileName(plotfilename + "/Header");
             std::ofstream HeaderFile;
@@ -205,37 +296,10 @@ WriteMultiLevelPlotfile (const std::string& plotfilename, int nlevels,
             WriteGenericPlotfileHeader(HeaderFile, nlevels, boxArrays, varnames,
                                        geom, time, level_steps, ref_ratio, versionName,
                                        levelPrefix, mfPrefix);
-        };
-
-        if (AsyncOut::UseAsyncOut()) {
-            AsyncOut::Submit(std::move(f));
-        } else {
-            f();
-        }
+        });
     }
 
-    for (int level = 0; level <= finest_level; ++level)
-    {
-        if (AsyncOut::UseAsyncOut()) {
-            VisMF::AsyncWrite(*mf[level],
-                              MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix),
-                              true);
-        } else {
-            const MultiFab* data;
-            std::unique_ptr<MultiFab> mf_tmp;
-            if (mf[level]->nGrowVect() != 0) {
-                mf_tmp = std::make_unique<MultiFab>(mf[level]->boxArray(),
-                                                    mf[level]->DistributionMap(),
-                                                    mf[level]->nComp(), 0, MFInfo(),
-                                                    mf[level]->Factory());
-                MultiFab::Copy(*mf_tmp, *mf[level], 0, 0, mf[level]->nComp(), 0);
-                data = mf_tmp.get();
-            } else {
-                data = mf[level];
-            }
-            VisMF::Write(*data, MultiFabFileFullPrefix(level, plotfilename, levelPrefix, mfPrefix));
-        }
-    }
+    return AsyncOut::Fence();
 }
 
 // write a plotfile to disk given:
@@ -0,0 +1,221 @@
+#include <AMReX_QuickLook.H>
+#include <AMReX_FPC.H>
+#include <AMReX_FabConv.H>
+#include <AMReX_Loop.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+namespace amrex {
+
+namespace {
+
+struct QuickLookDataset
+{
+    std::string   name;
+    Box           box;
+    Vector<float> data;
+};
+
+}
+
+QuickLook::QuickLook (const std::string& pp_prefix)
+{
+    ParmParse pp(pp_prefix);
+    pp.queryAdd("int", m_int);
+    pp.queryAdd("file", m_file_root);
+    pp.queryAdd("coarsen", m_coarsen);
+    pp.queryAdd("max_bytes", m_max_bytes);
+    pp.queryAdd("write_composite", m_write_composite);
+    pp.queryarr("slice_dir", m_slice_dir);
+    pp.queryarr("slice_coord", m_slice_coord);
+    pp.queryarr("project_dir", m_project_dir);
+
+    m_coarsen = std::max(m_coarsen, 1);
+
+    if (m_slice_dir.size() != m_slice_coord.size()) {
+        amrex::Abort("QuickLook: "+pp_prefix+".slice_dir and "+pp_prefix
+                     +".slice_coord must have the same number of entries");
+    }
+    for (int d : m_slice_dir) {
+        if (d < 0 || d >= AMREX_SPACEDIM) {
+            amrex::Abort("QuickLook: invalid "+pp_prefix+".slice_dir");
+        }
+    }
+    for (int d : m_project_dir) {
+        if (d < 0 || d >= AMREX_SPACEDIM) {
+            amrex::Abort("QuickLook: invalid "+pp_prefix+".project_dir");
+        }
+    }
+}
+
+int
+QuickLook::coarseningRatio (const Vector<const MultiFab*>& mf,
+                            const Vector<IntVect>& ref_ratio,
+                            int ncomp) const
+{
+    const int nlevs = static_cast<int>(mf.size());
+
+    // Every level must be coarsenable by its total ratio to the composite.
+    auto ok = [&] (int c) -> bool
+    {
+        IntVect ratio(c);
+        for (int lev = 0; lev < nlevs; ++lev) {
+            if (!mf[lev]->boxArray().coarsenable(ratio)) { return false; }
+            if (lev < nlevs-1) { ratio *= ref_ratio[lev]; }
+        }
+        return true;
+    };
+
+    const Box domain = mf[0]->boxArray().minimalBox();
+    auto nbytes = [&] (int c) -> Long
+    {
+        return amrex::coarsen(domain,c).numPts() * ncomp * Long(sizeof(Real));
+    };
+
+    int c = m_coarsen;
+    while (c > 1 && !ok(c)) { c /= 2; }
+    while (m_max_bytes > 0 && nbytes(c) > m_max_bytes && ok(2*c)) { c *= 2; }
+    return c;
+}
+
+void
+QuickLook::write (const std::string& filename,
+                  const Vector<const MultiFab*>& mf,
+                  const Vector<std::string>& varnames,
+                  const Vector<Geometry>& geom,
+                  const Vector<IntVect>& ref_ratio,
+                  Real time, int step) const
+{
+    BL_PROFILE("QuickLook::write()");
+
+    const int nlevs = static_cast<int>(mf.size());
+    const int ncomp = static_cast<int>(varnames.size());
+    AMREX_ALWAYS_ASSERT(nlevs > 0 && ncomp > 0);
+    AMREX_ALWAYS_ASSERT(static_cast<int>(ref_ratio.size()) >= nlevs-1);
+
+    const int c = coarseningRatio(mf, ref_ratio, ncomp);
+    const Box qdomain = amrex::coarsen(geom[0].Domain(), c);
+    const Geometry qgeom(qdomain, geom[0].ProbDomain(), geom[0].Coord(),
+                         geom[0].isPeriodic());
+
+    //
+    // Build the composite from coarse to fine so that finer data win.
+    //
+    BoxArray qba(qdomain);
+    qba.maxSize(32);
+    MultiFab q(qba, DistributionMapping(qba), ncomp, 0);
+    {
+        IntVect ratio(c);
+        for (int lev = 0; lev < nlevs; ++lev) {
+            amrex::average_down(*mf[lev], q, 0, ncomp, ratio);
+            if (lev < nlevs-1) { ratio *= ref_ratio[lev]; }
+        }
+    }
+
+    //
+    // The composite is small; gather it on the I/O processor and compute the
+    // slices and projections there.
+    //
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    MultiFab g(BoxArray(qdomain), DistributionMapping(Vector<int>{ioproc}), ncomp, 0,
+               MFInfo().SetArena(The_Pinned_Arena()));
+    g.ParallelCopy(q);
+
+    if (!ParallelDescriptor::IOProcessor()) { return; }
+
+    Gpu::streamSynchronize();
+    Array4<Real const> const& a = g.const_array(0);
+
+    Vector<QuickLookDataset> datasets;
+
+    if (m_write_composite) {
+        QuickLookDataset ds{"composite", qdomain, {}};
+        ds.data.reserve(qdomain.numPts()*ncomp);
+        amrex::LoopOnCpu(qdomain, ncomp, [&] (int i, int j, int k, int n)
+        {
+            ds.data.push_back(static_cast<float>(a(i,j,k,n)));
+        });
+        datasets.push_back(std::move(ds));
+    }
+
+    const Real* problo = qgeom.ProbLo();
+    const Real* dx = qgeom.CellSize();
+
+    for (int is = 0; is < m_slice_dir.size(); ++is) {
+        const int d = m_slice_dir[is];
+        int idx = static_cast<int>(std::floor((m_slice_coord[is]-problo[d])/dx[d]));
+        idx = std::min(std::max(idx, qdomain.smallEnd(d)), qdomain.bigEnd(d));
+        Box bx = qdomain;
+        bx.setRange(d, idx);
+        QuickLookDataset ds{"slice_"+std::to_string(d)+"_"+std::to_string(idx), bx, {}};
+        ds.data.reserve(bx.numPts()*ncomp);
+        amrex::LoopOnCpu(bx, ncomp, [&] (int i, int j, int k, int n)
+        {
+            ds.data.push_back(static_cast<float>(a(i,j,k,n)));
+        });
+        datasets.push_back(std::move(ds));
+    }
+
+    for (int d : m_project_dir) {
+        Box bx = qdomain;
+        bx.setRange(d, qdomain.smallEnd(d));
+        const int lo = qdomain.smallEnd(d);
+        const int hi = qdomain.bigEnd(d);
+        const Real fac = Real(1.0) / Real(hi-lo+1);
+        QuickLookDataset ds{"project_"+std::to_string(d), bx, {}};
+        ds.data.reserve(bx.numPts()*ncomp);
+        amrex::LoopOnCpu(bx, ncomp, [&] (int i, int j, int k, int n)
+        {
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real s = 0.0;
+            for (int m = lo; m <= hi; ++m) {
+                iv[d] = m;
+                s += a(iv,n);
+            }
+            ds.data.push_back(static_cast<float>(s*fac));
+        });
+        datasets.push_back(std::move(ds));
+    }
+
+    std::ofstream ofs(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!ofs.good()) {
+        amrex::FileOpenFailed(filename);
+    }
+
+    ofs << "QuickLook-V1\n";
+    ofs << std::setprecision(std::numeric_limits<Real>::max_digits10);
+    ofs << time << ' ' << step << '\n';
+    ofs << ncomp << '\n';
+    for (auto const& name : varnames) {
+        ofs << name << '\n';
+    }
+    ofs << c << '\n';
+    for (int i = 0; i < AMREX_SPACEDIM; ++i) { ofs << qgeom.ProbLo(i) << ' '; }
+    ofs << '\n';
+    for (int i = 0; i < AMREX_SPACEDIM; ++i) { ofs << qgeom.ProbHi(i) << ' '; }
+    ofs << '\n';
+    ofs << FPC::Native32RealDescriptor() << '\n';
+    ofs << datasets.size() << '\n';
+    Long offset = 0;
+    for (auto const& ds : datasets) {
+        ofs << ds.name << ' ' << ds.box << ' ' << offset << '\n';
+        offset += static_cast<Long>(ds.data.size() * sizeof(float));
+    }
+
+    for (auto const& ds : datasets) {
+        ofs.write(reinterpret_cast<const char*>(ds.data.data()),
+                  static_cast<std::streamsize>(ds.data.size() * sizeof(float)));
+    }
+
+    if (!ofs.good()) {
+        amrex::Error("QuickLook::write: failed to write "+filename);
+    }
+}
+
+}
@@ -0,0 +1,272 @@
+#include <AMReX_StartupCache.H>
+#include <AMReX.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+
+namespace amrex {
+namespace StartupCache {
+
+namespace {
+
+bool s_initialized = false;
+std::string s_dir;
+bool s_grids = false;
+std::string s_user_version;
+std::string s_code_version;
+std::string s_inputs;
+std::map<std::string,std::string> s_description;
+
+const char* const s_version = "StartupCache-V1";
+
+//! 64-bit FNV-1a, which unlike std::hash is the same in every run.
+std::uint64_t startup_cache_hash (std::string const& s)
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+std::string hex (std::uint64_t v)
+{
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << v;
+    return os.str();
+}
+
+std::string const& description (const std::string& key)
+{
+    auto it = s_description.find(key);
+    if (it == s_description.end()) {
+        amrex::Abort("StartupCache: unknown key "+key);
+    }
+    return it->second;
+}
+
+}
+
+void
+Initialize ()
+{
+    if (s_initialized) { return; }
+    s_initialized = true;
+
+    ParmParse pp("amrex");
+    pp.queryAdd("startup_cache", s_dir);
+    pp.queryAdd("startup_cache_grids", s_grids);
+    pp.queryAdd("startup_cache_version", s_user_version);
+
+    //
+    // Everything in the table up to here comes from the inputs or from the
+    // same code path in every run, so it is a stable description of the run.
+    //
+    std::ostringstream os;
+    ParmParse::dumpTable(os);
+    std::istringstream is(os.str());
+    for (std::string line; std::getline(is, line); ) {
+        if (line.compare(0, 19, "amrex.startup_cache") != 0) {
+            s_inputs += line;
+            s_inputs += '\n';
+        }
+    }
+
+    amrex::ExecOnFinalize(StartupCache::Finalize);
+}
+
+void
+Finalize ()
+{
+    s_dir.clear();
+    s_grids = false;
+    s_user_version.clear();
+    s_code_version.clear();
+    s_inputs.clear();
+    s_description.clear();
+    s_initialized = false;
+}
+
+bool
+enabled () noexcept
+{
+    return !s_dir.empty();
+}
+
+bool
+gridsEnabled () noexcept
+{
+    return enabled() && s_grids;
+}
+
+void
+setVersion (const std::string& version)
+{
+    s_code_version = version;
+}
+
+std::string
+makeKey (const std::string& what, const Vector<std::string>& prefixes,
+         const std::string& extra)
+{
+    // The startup_cache parameters are not in s_inputs, so that sharing a
+    // cache does not depend on them, except for the versions.
+    std::string desc = what + '\n'
+        + "version = " + s_user_version + '\n'
+        + "code_version = " + s_code_version + '\n';
+    std::istringstream is(s_inputs);
+    for (std::string line; std::getline(is, line); ) {
+        bool keep = prefixes.empty();
+        for (auto const& p : prefixes) {
+            keep = keep || (line.compare(0, p.size(), p) == 0);
+        }
+        if (keep) {
+            desc += line;
+            desc += '\n';
+        }
+    }
+    desc += extra;
+    desc += '\n';
+
+    std::string key = what + '_' + hex(startup_cache_hash(desc));
+    s_description[key] = std::move(desc);
+    return key;
+}
+
+std::string
+hashFile (const std::string& filename)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(filename, buf);
+    return hex(startup_cache_hash(std::string(buf.begin(), buf.end())));
+}
+
+std::string
+entryPath (const std::string& key)
+{
+    return s_dir + '/' + key;
+}
+
+bool
+exists (const std::string& key)
+{
+    int r = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ifstream ifs(entryPath(key)+"/Header");
+        if (ifs.good()) {
+            std::ostringstream os;
+            os << ifs.rdbuf();
+            r = (os.str() == std::string(s_version) + '\n' + description(key));
+            if (!r && amrex::Verbose() > 0) {
+                amrex::Print() << "StartupCache: entry " << key
+                               << " does not match the inputs and is ignored\n";
+            }
+        }
+    }
+    ParallelDescriptor::Bcast(&r, 1, ParallelDescriptor::IOProcessorNumber());
+    if (r && amrex::Verbose() > 0) {
+        amrex::Print() << "StartupCache: using " << entryPath(key) << "\n";
+    }
+    return r;
+}
+
+std::string
+beginWrite (const std::string& key)
+{
+    // Names of private directories must differ between jobs started at
+    // the same time, so they cannot come from amrex::Random.
+    Long id = 0;
+    if (ParallelDescriptor::IOProcessor()) {
+        std::random_device rd;
+        id = static_cast<Long>((std::uint64_t(rd()) << 31) ^ rd());
+    }
+    ParallelDescriptor::Bcast(&id, 1, ParallelDescriptor::IOProcessorNumber());
+
+    std::string dir = entryPath(key) + ".tmp." + hex(static_cast<std::uint64_t>(id));
+    if (ParallelDescriptor::IOProcessor()) {
+        if (!amrex::UtilCreateDirectory(dir, 0755)) {
+            amrex::CreateDirectoryFailed(dir);
+        }
+    }
+    ParallelDescriptor::Barrier();
+    return dir;
+}
+
+void
+commit (const std::string& key, const std::string& dir)
+{
+    ParallelDescriptor::Barrier();
+    if (ParallelDescriptor::IOProcessor()) {
+        {
+            std::ofstream ofs(dir+"/Header");
+            ofs << s_version << '\n' << description(key);
+            if (!ofs.good()) {
+                amrex::Abort("StartupCache: failed to write "+dir+"/Header");
+            }
+        }
+        const std::string path = entryPath(key);
+        if (std::rename(dir.c_str(), path.c_str()) != 0) {
+            // Another job has published the same entry.
+            FileSystem::RemoveAll(dir);
+        } else if (amrex::Verbose() > 0) {
+            amrex::Print() << "StartupCache: wrote " << path << "\n";
+        }
+    }
+    ParallelDescriptor::Barrier();
+}
+
+void
+writeGrids (const std::string& dir, const Vector<BoxArray>& grids,
+            const Vector<DistributionMapping>& dmap)
+{
+    AMREX_ALWAYS_ASSERT(grids.size() == dmap.size());
+    if (ParallelDescriptor::IOProcessor()) {
+        const std::string fname = dir+"/Grids";
+        std::ofstream ofs(fname);
+        ofs << grids.size() << '\n';
+        for (int lev = 0; lev < grids.size(); ++lev) {
+            grids[lev].writeOn(ofs);
+            ofs << '\n';
+            dmap[lev].writeOn(ofs);
+            ofs << '\n';
+        }
+        if (!ofs.good()) {
+            amrex::Abort("StartupCache: failed to write "+fname);
+        }
+    }
+}
+
+void
+readGrids (const std::string& dir, Vector<BoxArray>& grids,
+           Vector<DistributionMapping>& dmap)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(dir+"/Grids", buf);
+    std::istringstream is(buf.dataPtr());
+    int nlevs = 0;
+    is >> nlevs;
+    grids.clear();
+    dmap.clear();
+    grids.resize(nlevs);
+    dmap.resize(nlevs);
+    for (int lev = 0; lev < nlevs; ++lev) {
+        grids[lev].readFrom(is);
+        dmap[lev].readFrom(is);
+    }
+    if (is.fail()) {
+        amrex::Abort("StartupCache: failed to read "+dir+"/Grids");
+    }
+}
+
+}}
@@ -2,6 +2,7 @@
 // BL_PROFILE_VAR_NS, and BL_PROFILE_REGION.
 
 #include <AMReX_TinyProfiler.H>
+#include <AMReX_OpenMP.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParallelReduce.H>
 #include <AMReX_Utility.H>
@@ -16,51 +17,326 @@
 #include <cupti.h>
 #endif
 
-#ifdef AMREX_USE_OMP
-#include <omp.h>
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <x86intrin.h>
+#define AMREX_TINY_PROFILER_USE_TSC 1
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define AMREX_TINY_PROFILER_USE_PERF 1
 #endif
 
 #include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <cerrno>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 namespace amrex {
 
-std::vector<std::string>          TinyProfiler::regionstack;
-std::deque<std::tuple<double,double,std::string*> > TinyProfiler::ttstack;
-std::map<std::string,std::map<std::string, TinyProfiler::Stats> > TinyProfiler::statsmap;
+std::vector<int>  TinyProfiler::regionstack;
 double TinyProfiler::t_init = std::numeric_limits<double>::max();
+std::uint64_t TinyProfiler::tick_init = 0;
 int TinyProfiler::device_synchronize_around_region = 0;
 int TinyProfiler::n_print_tabs = 0;
 int TinyProfiler::verbose = 0;
+int TinyProfiler::all_threads = 0;
+std::vector<std::function<void()> > TinyProfiler::reports;
+bool TinyProfiler::trace_enabled = false;
+Long TinyProfiler::trace_max_events = 100000;
+int TinyProfiler::trace_sample = 1;
+std::string TinyProfiler::trace_file = "tinyprof_trace.json";
+int TinyProfiler::trace_step = -1;
+thread_local int TinyProfiler::trace_box = -1;
+int TinyProfiler::hw_counters = 0;
+int TinyProfiler::hw_nevents = 3;
+double TinyProfiler::hw_line_bytes = 64.0;
+double TinyProfiler::hw_peak_bandwidth = 0.0;
+double TinyProfiler::hw_peak_ipc = 4.0;
 
 namespace {
+    std::mutex nesting_mutex;
     std::set<std::string> improperly_nested_timers;
     static constexpr char mainregion[] = "main";
+    std::uint64_t hw_flops_config = 0;
+    std::atomic<bool> hw_warned{false};
+
+    //! The cycle counter if available, a steady clock otherwise.
+    inline std::uint64_t ticks () noexcept
+    {
+#ifdef AMREX_TINY_PROFILER_USE_TSC
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    //! Names are never removed, so references to them stay valid.
+    struct NameRegistry
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string,int> ids;
+        std::deque<std::string> names;
+
+        int intern (const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto r = ids.emplace(name, static_cast<int>(names.size()));
+            if (r.second) {
+                names.push_back(name);
+            }
+            return r.first->second;
+        }
+
+        const std::string& name (int id)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return names[id];
+        }
+    };
+
+    NameRegistry& timer_registry ()
+    {
+        static NameRegistry r;
+        return r;
+    }
+
+    NameRegistry& region_registry ()
+    {
+        static NameRegistry r;
+        return r;
+    }
+
+#ifdef AMREX_TINY_PROFILER_USE_PERF
+    //! Open a counter of the calling thread, in user space only.
+    int perf_open (std::uint32_t type, std::uint64_t config, int group_fd)
+    {
+        perf_event_attr pe;
+        std::memset(&pe, 0, sizeof(pe));
+        pe.type = type;
+        pe.size = sizeof(pe);
+        pe.config = config;
+        pe.disabled = (group_fd == -1) ? 1 : 0;
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+        pe.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+            | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &pe, 0, -1, group_fd, 0));
+    }
+#endif
+
+    void write_json_string (std::ostream& os, const std::string& s)
+    {
+        os << '"';
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                os << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                os << ' ';
+            } else {
+                os << c;
+            }
+        }
+        os << '"';
+    }
+
+}
+
+TinyProfiler::Stats&
+TinyProfiler::ThreadData::get (int region, int timer)
+{
+    if (region >= static_cast<int>(stats.size())) {
+        stats.resize(region+1);
+    }
+    auto& rstats = stats[region];
+    if (timer >= static_cast<int>(rstats.size())) {
+        rstats.resize(timer+1);
+    }
+    return rstats[timer];
+}
+
+void
+TinyProfiler::ThreadData::record (TraceEvent const& e)
+{
+    if (trace_ncalls++ % trace_sample != 0) { return; }
+    if (static_cast<Long>(trace.size()) < trace_max_events) {
+        trace.push_back(e);
+    } else if (!trace.empty()) {
+        trace[trace_next] = e;
+        trace_next = (trace_next+1) % trace.size();
+        ++trace_nlost;
+    }
+}
+
+std::vector<std::unique_ptr<TinyProfiler::ThreadData> >&
+TinyProfiler::ThreadDataList ()
+{
+    static std::vector<std::unique_ptr<ThreadData> > list;
+    return list;
+}
+
+TinyProfiler::ThreadData*
+TinyProfiler::GetThreadData ()
+{
+    static std::mutex list_mutex;
+    static thread_local ThreadData* td = nullptr;
+    if (td == nullptr) {
+        std::lock_guard<std::mutex> lock(list_mutex);
+        ThreadDataList().push_back(std::make_unique<ThreadData>());
+        td = ThreadDataList().back().get();
+        td->tid = static_cast<int>(ThreadDataList().size()) - 1;
+    }
+    return td;
+}
+
+int
+TinyProfiler::RegisterTimer (const std::string& name)
+{
+    return timer_registry().intern(name);
+}
+
+int
+TinyProfiler::LookupTimer (const std::string& name)
+{
+    auto& cache = GetThreadData()->name_cache;
+    auto it = cache.find(name);
+    if (it == cache.end()) {
+        it = cache.emplace(name, RegisterTimer(name)).first;
+    }
+    return it->second;
+}
+
+double
+TinyProfiler::TicksPerSecond ()
+{
+#ifdef AMREX_TINY_PROFILER_USE_TSC
+    // Calibrate the cycle counter against the wall clock since Initialize.
+    double dt = amrex::second() - t_init;
+    while (dt < 1.e-2) {
+        dt = amrex::second() - t_init;
+    }
+    return static_cast<double>(ticks() - tick_init) / dt;
+#else
+    using period = std::chrono::steady_clock::period;
+    return static_cast<double>(period::den) / static_cast<double>(period::num);
+#endif
+}
+
+bool
+TinyProfiler::ReadCounters (ThreadData& td, std::uint64_t* v)
+{
+#ifdef AMREX_TINY_PROFILER_USE_PERF
+    if (td.hw_fd == -2) {
+        // cycles, instructions, last level cache misses, and the optional
+        // flop event are read together as one group.
+        int fds[4] = {-1, -1, -1, -1};
+        fds[0] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (fds[0] >= 0) {
+            fds[1] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fds[0]);
+            fds[2] = perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, fds[0]);
+            if (hw_nevents == 4) {
+                fds[3] = perf_open(PERF_TYPE_RAW, hw_flops_config, fds[0]);
+            }
+        }
+        bool ok = true;
+        for (int k = 0; k < hw_nevents; ++k) { ok = ok && fds[k] >= 0; }
+        if (ok) {
+            ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            td.hw_fd = fds[0];
+            for (int k = 0; k < 4; ++k) { td.hw_fds[k] = fds[k]; }
+        } else {
+            for (int fd : fds) {
+                if (fd >= 0) { close(fd); }
+            }
+            td.hw_fd = -1;
+            if (!hw_warned.exchange(true)) {
+                amrex::AllPrint() << "TinyProfiler: perf_event_open failed on process "
+                                  << ParallelDescriptor::MyProc() << ": " << std::strerror(errno)
+                                  << "; no hardware counters will be recorded.  Check"
+                                  << " /proc/sys/kernel/perf_event_paranoid.\n";
+            }
+        }
+    }
+
+    if (td.hw_fd < 0) { return false; }
+
+    struct {
+        std::uint64_t nr, time_enabled, time_running, values[4];
+    } buf;
+    if (read(td.hw_fd, &buf, sizeof(buf)) < static_cast<ssize_t>(3+hw_nevents)*8) {
+        return false;
+    }
+    // Scale up if the counters had to be multiplexed.
+    const double scale = (buf.time_running > 0 && buf.time_running < buf.time_enabled)
+        ? static_cast<double>(buf.time_enabled) / static_cast<double>(buf.time_running) : 1.0;
+    for (int k = 0; k < hw_nevents; ++k) {
+        v[k] = static_cast<std::uint64_t>(static_cast<double>(buf.values[k]) * scale);
+    }
+    return true;
+#else
+    amrex::ignore_unused(td, v);
+    return false;
+#endif
+}
+
+void
+TinyProfiler::CloseCounters (ThreadData& td)
+{
+#ifdef AMREX_TINY_PROFILER_USE_PERF
+    for (int& fd : td.hw_fds) {
+        if (fd >= 0) { close(fd); }
+        fd = -1;
+    }
+#endif
+    // Timers that run after Finalize will not reopen them.
+    td.hw_fd = -1;
 }
 
 TinyProfiler::TinyProfiler (std::string funcname) noexcept
-    : fname(std::move(funcname)), uCUPTI(false)
+    : m_id(LookupTimer(funcname)), uCUPTI(false)
 {
     start();
 }
 
 TinyProfiler::TinyProfiler (std::string funcname, bool start_, bool useCUPTI) noexcept
-    : fname(std::move(funcname)), uCUPTI(useCUPTI)
+    : m_id(LookupTimer(funcname)), uCUPTI(useCUPTI)
 {
     if (start_) start();
 }
 
 TinyProfiler::TinyProfiler (const char* funcname) noexcept
-    : fname(funcname), uCUPTI(false)
+    : m_id(LookupTimer(funcname)), uCUPTI(false)
 {
     start();
 }
 
 TinyProfiler::TinyProfiler (const char* funcname, bool start_, bool useCUPTI) noexcept
-    : fname(funcname), uCUPTI(useCUPTI)
+    : m_id(LookupTimer(funcname)), uCUPTI(useCUPTI)
+{
+    if (start_) start();
+}
+
+TinyProfiler::TinyProfiler (int timer_id) noexcept
+    : m_id(timer_id), uCUPTI(false)
+{
+    start();
+}
+
+TinyProfiler::TinyProfiler (int timer_id, bool start_, bool useCUPTI) noexcept
+    : m_id(timer_id), uCUPTI(useCUPTI)
 {
     if (start_) start();
 }
@@ -73,77 +349,76 @@ TinyProfiler::~TinyProfiler ()
 void
 TinyProfiler::start () noexcept
 {
-#ifdef AMREX_USE_OMP
-#pragma omp master
-#endif
-    if (stats.empty() && !regionstack.empty())
-    {
-        double t;
-        if (!uCUPTI) {
-            t = amrex::second();
-        } else {
+    if (nstats > 0 || regionstack.empty()) {
+        return;
+    }
+
+    const bool master = OpenMP::get_thread_num() == 0;
+    if (!master && !all_threads) {
+        return;
+    }
+
+    tdata = GetThreadData();
+
 #ifdef AMREX_USE_CUPTI
-            cudaDeviceSynchronize();
-            cuptiActivityFlushAll(0);
-            activityRecordUserdata.clear();
-            t = amrex::second();
+    if (uCUPTI) {
+        cudaDeviceSynchronize();
+        cuptiActivityFlushAll(0);
+        activityRecordUserdata.clear();
+    }
 #endif
-        }
 
-        ttstack.emplace_back(std::make_tuple(t, 0.0, &fname));
-        global_depth = ttstack.size();
+    tdata->ttstack.push_back(TimerFrame{ticks(), 0.0, m_id, trace_box, {}});
+    global_depth = static_cast<int>(tdata->ttstack.size());
 
 #ifdef AMREX_USE_GPU
-            if (device_synchronize_around_region) {
-                amrex::Gpu::streamSynchronize();
-            }
+    if (device_synchronize_around_region && master) {
+        amrex::Gpu::streamSynchronize();
+    }
 #endif
 
 #ifdef AMREX_USE_CUDA
-        nvtxRangePush(fname.c_str());
+    nvtxRangePush(timer_registry().name(m_id).c_str());
 #elif defined(AMREX_USE_HIP) && defined(AMREX_USE_ROCTX)
-        roctxRangePush(fname.c_str());
+    roctxRangePush(timer_registry().name(m_id).c_str());
 #endif
 
-        for (auto const& region : regionstack)
-        {
-            Stats& st = statsmap[region][fname];
-            ++st.depth;
-            stats.push_back(&st);
+    for (int region : regionstack)
+    {
+        Stats& st = tdata->get(region, m_id);
+        ++st.depth;
+        if (nstats < max_regions) {
+            stats[nstats] = &st;
+        } else {
+            stats_overflow.push_back(&st);
         }
+        ++nstats;
+    }
 
-        if (verbose) {
-            ++n_print_tabs;
-            std::string whitespace;
-            for (int itab = 0; itab < n_print_tabs; ++itab) {
-                whitespace += "  ";
-            }
-            amrex::Print() << whitespace << "TP: Entering " << fname << std::endl;
+    if (verbose && master) {
+        ++n_print_tabs;
+        std::string whitespace;
+        for (int itab = 0; itab < n_print_tabs; ++itab) {
+            whitespace += "  ";
         }
+        amrex::Print() << whitespace << "TP: Entering " << timer_registry().name(m_id) << std::endl;
+    }
+
+    // Read the counters last so that the bookkeeping above is not counted.
+    if (hw_counters) {
+        ReadCounters(*tdata, tdata->ttstack[global_depth-1].hw0);
     }
 }
 
 void
 TinyProfiler::stop () noexcept
 {
-#ifdef AMREX_USE_OMP
-#pragma omp master
-#endif
-    if (!stats.empty())
+    if (nstats > 0)
     {
-        double t;
+        const bool master = OpenMP::get_thread_num() == 0;
+        double dtin;
         int nKernelCalls = 0;
-#ifdef AMREX_USE_CUPTI
-        if (uCUPTI) {
-            cudaDeviceSynchronize();
-            cuptiActivityFlushAll(0);
-            t = computeElapsedTimeUserdata(activityRecordUserdata);
-            nKernelCalls = activityRecordUserdata.size();
-        } else
-#endif
-        {
-            t = amrex::second();
-        }
+        auto& ttstack = tdata->ttstack;
 
         while (static_cast<int>(ttstack.size()) > global_depth) {
             ttstack.pop_back();
@@ -151,26 +426,38 @@ TinyProfiler::stop () noexcept
 
         if (static_cast<int>(ttstack.size()) == global_depth)
         {
-            const std::tuple<double,double,std::string*>& tt = ttstack.back();
-
-            // first: wall time when the pair is pushed into the stack
-            // second: accumulated dt of children
-            double dtin;
-            double dtex;
-            if (!uCUPTI) {
-                dtin = t - std::get<0>(tt); // elapsed time since start() is called.
-                dtex = dtin - std::get<1>(tt);
-            } else {
-                dtin = t;
-                dtex = dtin - std::get<1>(tt);
+            const TimerFrame& tt = ttstack.back();
+
+            std::uint64_t hw1[4];
+            const bool has_hw = hw_counters && ReadCounters(*tdata, hw1);
+
+            // t0: tick when the frame is pushed into the stack
+            // dtchildren: accumulated dt of children
+#ifdef AMREX_USE_CUPTI
+            if (uCUPTI) {
+                cudaDeviceSynchronize();
+                cuptiActivityFlushAll(0);
+                dtin = computeElapsedTimeUserdata(activityRecordUserdata) * TicksPerSecond();
+                nKernelCalls = activityRecordUserdata.size();
+            } else
+#endif
+            {
+                dtin = static_cast<double>(ticks() - tt.t0); // elapsed ticks since start() is called.
             }
+            double dtex = dtin - tt.dtchildren;
 
-            for (Stats* st : stats)
+            for (int i = 0; i < nstats; ++i)
             {
+                Stats* st = (i < max_regions) ? stats[i] : stats_overflow[i-max_regions];
                 --(st->depth);
                 ++(st->n);
                 if (st->depth == 0) {
                     st->dtin += dtin;
+                    if (has_hw) {
+                        for (int k = 0; k < hw_nevents; ++k) {
+                            st->hw[k] += static_cast<double>(hw1[k] - tt.hw0[k]);
+                        }
+                    }
                 }
                 st->dtex += dtex;
                 st->usesCUPTI = uCUPTI;
@@ -179,14 +466,18 @@ TinyProfiler::stop () noexcept
                 }
             }
 
+            if (trace_enabled) {
+                tdata->record(TraceEvent{tt.t0, tt.t0+static_cast<std::uint64_t>(dtin),
+                                         m_id, tt.box, trace_step});
+            }
+
             ttstack.pop_back();
             if (!ttstack.empty()) {
-                std::tuple<double,double,std::string*>& parent = ttstack.back();
-                std::get<1>(parent) += dtin;
+                ttstack.back().dtchildren += dtin;
             }
 
 #ifdef AMREX_USE_GPU
-            if (device_synchronize_around_region) {
+            if (device_synchronize_around_region && master) {
                 amrex::Gpu::streamSynchronize();
             }
 #endif
@@ -197,18 +488,20 @@ TinyProfiler::stop () noexcept
             roctxRangePop();
 #endif
         } else {
-            improperly_nested_timers.insert(fname);
+            std::lock_guard<std::mutex> lock(nesting_mutex);
+            improperly_nested_timers.insert(timer_registry().name(m_id));
         }
 
-        stats.clear();
+        nstats = 0;
+        stats_overflow.clear();
 
-        if (verbose) {
+        if (verbose && master) {
             std::string whitespace;
             for (int itab = 0; itab < n_print_tabs; ++itab) {
                 whitespace += "  ";
             }
             --n_print_tabs;
-            amrex::Print() << whitespace << "TP: Leaving  " << fname << std::endl;
+            amrex::Print() << whitespace << "TP: Leaving  " << timer_registry().name(m_id) << std::endl;
         }
     }
 }
@@ -217,93 +510,68 @@ TinyProfiler::stop () noexcept
 void
 TinyProfiler::stop (unsigned boxUintID) noexcept
 {
-#ifdef AMREX_USE_OMP
-#pragma omp master
-#endif
-    if (!stats.empty())
+    if (nstats > 0)
     {
-        double t;
         cudaDeviceSynchronize();
         cuptiActivityFlushAll(0);
-        t = computeElapsedTimeUserdata(activityRecordUserdata);
-        int nKernelCalls = activityRecordUserdata.size();
-
         for (auto& record : activityRecordUserdata)
         {
             record->setUintID(boxUintID);
         }
-
-        while (static_cast<int>(ttstack.size()) > global_depth)
-        {
-            ttstack.pop_back();
-        };
-
-        if (static_cast<int>(ttstack.size()) == global_depth)
-        {
-            const std::tuple<double,double,std::string*>& tt = ttstack.back();
-
-            // first: wall time when the pair is pushed into the stack
-            // second: accumulated dt of children
-            double dtin;
-            double dtex;
-
-            dtin = t;
-            dtex = dtin - std::get<1>(tt);
-
-            for (Stats* st : stats)
-            {
-                --(st->depth);
-                ++(st->n);
-                if (st->depth == 0)
-                {
-                    st->dtin += dtin;
-                }
-                st->dtex += dtex;
-                st->usesCUPTI = uCUPTI;
-                st->nk += nKernelCalls;
-            }
-
-            ttstack.pop_back();
-            if (!ttstack.empty())
-            {
-                std::tuple<double,double,std::string*>& parent = ttstack.back();
-                std::get<1>(parent) += dtin;
-            }
-
-            if (device_synchronize_around_region) {
-                amrex::Gpu::streamSynchronize();
-            }
-
-#ifdef AMREX_USE_CUDA
-            nvtxRangePop();
-#elif defined(AMREX_USE_HIP) && defined(AMREX_USE_ROCTX)
-            roctxRangePop();
-#endif
-        } else
-        {
-            improperly_nested_timers.insert(fname);
-        }
-
-        stats.clear();
-    }
-    if (verbose) {
-        amrex::Print() << "  TP: Leaving " << fname << std::endl;
     }
+    stop();
 }
 #endif
 
 void
 TinyProfiler::Initialize () noexcept
 {
-    regionstack.push_back(mainregion);
-    t_init = amrex::second();
-
     {
         amrex::ParmParse pp("tiny_profiler");
         pp.queryAdd("device_synchronize_around_region", device_synchronize_around_region);
         pp.queryAdd("verbose", verbose);
         pp.queryAdd("v", verbose);
+        pp.queryAdd("all_threads", all_threads);
+        pp.queryAdd("trace", trace_enabled);
+        pp.queryAdd("trace_max_events", trace_max_events);
+        pp.queryAdd("trace_sample", trace_sample);
+        pp.queryAdd("trace_file", trace_file);
+        trace_sample = std::max(trace_sample, 1);
+
+        pp.queryAdd("hw_counters", hw_counters);
+        std::string flops_event;
+        pp.query("hw_flops_event", flops_event);
+        if (!flops_event.empty()) {
+            char* endptr = nullptr;
+            errno = 0;
+            hw_flops_config = std::strtoull(flops_event.c_str(), &endptr, 0);
+            if (errno != 0 || endptr == flops_event.c_str() || *endptr != '\0') {
+                amrex::Warning("TinyProfiler: invalid tiny_profiler.hw_flops_event = "
+                               + flops_event + "; no flop counts will be recorded");
+                hw_flops_config = 0;
+            } else {
+                hw_nevents = 4;
+            }
+        }
+        pp.queryAdd("hw_line_bytes", hw_line_bytes);
+        pp.queryAdd("hw_peak_bandwidth", hw_peak_bandwidth);
+        pp.queryAdd("hw_peak_ipc", hw_peak_ipc);
+#ifndef AMREX_TINY_PROFILER_USE_PERF
+        if (hw_counters) {
+            amrex::Print() << "TinyProfiler: hardware counters are only supported on Linux\n";
+            hw_counters = 0;
+        }
+#endif
+    }
+
+    // The trace of every process starts at tick_init, so line them up.
+    if (trace_enabled) {
+        ParallelDescriptor::Barrier();
     }
+
+    regionstack.push_back(region_registry().intern(mainregion));
+    t_init = amrex::second();
+    tick_init = ticks();
 }
 
 void
@@ -319,9 +587,44 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
     }
 
     double t_final = amrex::second();
+    const double sec_per_tick = 1.0 / TicksPerSecond();
+
+    // Combine the threads into a local copy so that any functions called
+    // after this will not be recorded in the local copy.  The times and the
+    // call counts of a timer are the maximum over the threads, so that the
+    // per-call averages refer to the busiest thread.  Hardware counts are
+    // summed because they measure the total work.
+    std::map<std::string,std::map<std::string,Stats> > lstatsmap;
+    for (auto const& td : ThreadDataList()) {
+        for (int r = 0; r < static_cast<int>(td->stats.size()); ++r) {
+            auto const& rstats = td->stats[r];
+            auto& lregstats = lstatsmap[region_registry().name(r)];
+            for (int t = 0; t < static_cast<int>(rstats.size()); ++t) {
+                Stats const& st = rstats[t];
+                if (st.n == 0 && st.depth == 0) { continue; }
+                Stats& lst = lregstats[timer_registry().name(t)];
+                lst.n = std::max(lst.n, st.n);
+                lst.dtin = std::max(lst.dtin, st.dtin*sec_per_tick);
+                lst.dtex = std::max(lst.dtex, st.dtex*sec_per_tick);
+                lst.usesCUPTI = lst.usesCUPTI || st.usesCUPTI;
+                lst.nk = std::max(lst.nk, st.nk);
+                for (int k = 0; k < 4; ++k) {
+                    lst.hw[k] += st.hw[k];
+                }
+            }
+        }
+    }
+    lstatsmap[mainregion];
+
+    if (!bFlushing) {
+        for (auto const& td : ThreadDataList()) {
+            CloseCounters(*td);
+        }
+    }
 
-    // make a local copy so that any functions call after this will not be recorded in the local copy.
-    auto lstatsmap = statsmap;
+    if (trace_enabled) {
+        WriteTrace(sec_per_tick);
+    }
 
     bool properly_nested = improperly_nested_timers.size() == 0;
     ParallelDescriptor::ReduceBoolAnd(properly_nested);
@@ -385,6 +688,9 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
     }
 
     PrintStats(lstatsmap[mainregion], dt_max);
+    if (hw_counters) {
+        PrintCounters(lstatsmap[mainregion]);
+    }
     for (auto& kv : lstatsmap) {
         if (kv.first != mainregion) {
             amrex::Print() << "\n\nBEGIN REGION " << kv.first << "\n";
@@ -392,6 +698,171 @@ TinyProfiler::Finalize (bool bFlushing) noexcept
             amrex::Print() << "END REGION " << kv.first << "\n";
         }
     }
+
+    for (auto const& f : reports) {
+        f();
+    }
+    if (!bFlushing) {
+        reports.clear();
+    }
+}
+
+void
+TinyProfiler::PrintCounters (std::map<std::string,Stats>& regstats)
+{
+    // PrintStats has made the set of timers the same on all processes.
+    const int ioproc = ParallelDescriptor::IOProcessorNumber();
+    const int nv = 5;
+    std::vector<double> v;
+    v.reserve(regstats.size()*nv);
+    for (auto const& kv : regstats) {
+        v.push_back(kv.second.dtin);
+        for (int k = 0; k < 4; ++k) {
+            v.push_back(kv.second.hw[k]);
+        }
+    }
+    ParallelReduce::Sum(v.data(), static_cast<int>(v.size()), ioproc,
+                        ParallelDescriptor::Communicator());
+
+    if (!ParallelDescriptor::IOProcessor()) { return; }
+
+    struct Row {
+        std::string name;
+        double cycles, ipc, misses, bytes, bw, intensity;
+    };
+    std::vector<Row> rows;
+    double max_bw = 0.0;
+    int i = 0;
+    for (auto const& kv : regstats) {
+        const double* x = v.data() + nv*(i++);
+        if (x[1] <= 0.0) { continue; }
+        Row r;
+        r.name = kv.first;
+        r.cycles = x[1];
+        r.ipc = x[2] / x[1];
+        r.misses = x[3];
+        r.bytes = x[3] * hw_line_bytes;
+        r.bw = (x[0] > 0.0) ? r.bytes / x[0] : 0.0; // per process
+        const double ops = (hw_nevents == 4) ? x[4] : x[2];
+        r.intensity = (r.bytes > 0.0) ? ops / r.bytes : std::numeric_limits<double>::infinity();
+        max_bw = std::max(max_bw, r.bw);
+        rows.push_back(r);
+    }
+    if (rows.empty()) { return; }
+
+    std::sort(rows.begin(), rows.end(),
+              [] (Row const& a, Row const& b) { return a.cycles > b.cycles; });
+
+    const double peak_bw = (hw_peak_bandwidth > 0.0) ? hw_peak_bandwidth*1.e9 : max_bw;
+
+    int maxfnamelen = int(std::string("Name").size());
+    for (auto const& r : rows) {
+        maxfnamelen = std::max(maxfnamelen, int(r.name.size()));
+    }
+    const int w = 11;
+    const std::string hline(maxfnamelen+(w+2)*6+11, '-');
+    const char* opname = (hw_nevents == 4) ? "Flop/B" : "Ins/B";
+
+    auto& os = amrex::OutStream();
+    os << "\nHardware counters (inclusive, summed over processes and threads)\n"
+       << hline << "\n" << std::left << std::setw(maxfnamelen) << "Name" << std::right
+       << std::setw(w+2) << "Cycles" << std::setw(w+2) << "IPC"
+       << std::setw(w+2) << "LLC Misses" << std::setw(w+2) << "GB"
+       << std::setw(w+2) << "GB/s/Proc" << std::setw(w+2) << opname
+       << std::setw(11) << "Bound" << "\n" << hline << "\n";
+    for (auto const& r : rows) {
+        // Roofline-style classification: a timer close to the peak
+        // bandwidth is bandwidth bound, one close to the peak IPC is compute
+        // bound, and one close to neither is latency bound.
+        const double bw_frac = (peak_bw > 0.0) ? r.bw / peak_bw : 0.0;
+        const double ipc_frac = r.ipc / hw_peak_ipc;
+        const char* bound = (bw_frac >= 0.5 && bw_frac >= ipc_frac) ? "bandwidth"
+                          : (ipc_frac >= 0.5)                       ? "compute"
+                          :                                           "latency";
+        os << std::setprecision(4) << std::left << std::setw(maxfnamelen) << r.name
+           << std::right
+           << std::setw(w+2) << r.cycles
+           << std::setw(w+2) << r.ipc
+           << std::setw(w+2) << r.misses
+           << std::setw(w+2) << r.bytes*1.e-9
+           << std::setw(w+2) << r.bw*1.e-9
+           << std::setw(w+2) << r.intensity
+           << std::setw(11) << bound << "\n";
+    }
+    os << hline << "\n" << std::endl;
+}
+
+void
+TinyProfiler::WriteTrace (double sec_per_tick)
+{
+    // The processes append to one file in turn.
+    const int myproc = ParallelDescriptor::MyProc();
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int tag = ParallelDescriptor::SeqNum();
+    int token = 0;
+    if (myproc > 0) {
+        ParallelDescriptor::Recv(&token, 1, myproc-1, tag);
+    }
+
+    Long nevents = 0, nlost = 0;
+    {
+        std::ofstream ofs(trace_file, (myproc == 0) ? std::ios::out | std::ios::trunc
+                                                    : std::ios::out | std::ios::app);
+        if (!ofs.good()) {
+            amrex::FileOpenFailed(trace_file);
+        }
+
+        if (myproc == 0) {
+            ofs << "{\"traceEvents\":[\n";
+        } else {
+            ofs << ",\n";
+        }
+        ofs << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << myproc
+            << ",\"args\":{\"name\":\"rank " << myproc << "\"}}";
+
+        const double us_per_tick = 1.e6 * sec_per_tick;
+        ofs << std::fixed << std::setprecision(3);
+        for (auto const& td : ThreadDataList()) {
+            ofs << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << myproc
+                << ",\"tid\":" << td->tid << ",\"args\":{\"name\":\"thread "
+                << td->tid << "\"}}";
+            const std::size_t n = td->trace.size();
+            for (std::size_t i = 0; i < n; ++i) {
+                TraceEvent const& e = td->trace[(td->trace_next+i) % n];
+                ofs << ",\n{\"name\":";
+                write_json_string(ofs, timer_registry().name(e.id));
+                ofs << ",\"ph\":\"X\",\"pid\":" << myproc << ",\"tid\":" << td->tid
+                    << ",\"ts\":" << static_cast<double>(e.t0-tick_init)*us_per_tick
+                    << ",\"dur\":" << static_cast<double>(e.t1-e.t0)*us_per_tick
+                    << ",\"args\":{\"step\":" << e.step << ",\"box\":" << e.box << "}}";
+            }
+            nevents += static_cast<Long>(n);
+            nlost += td->trace_nlost;
+        }
+
+        if (myproc == nprocs-1) {
+            ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        }
+    }
+
+    if (myproc < nprocs-1) {
+        ParallelDescriptor::Send(&token, 1, myproc+1, tag);
+    }
+
+    ParallelDescriptor::ReduceLongSum(nevents, ParallelDescriptor::IOProcessorNumber());
+    ParallelDescriptor::ReduceLongSum(nlost, ParallelDescriptor::IOProcessorNumber());
+    amrex::Print() << "TinyProfiler: wrote " << nevents << " trace events to " << trace_file;
+    if (nlost > 0) {
+        amrex::Print() << " (" << nlost << " older events were dropped,"
+                       << " see tiny_profiler.trace_max_events)";
+    }
+    amrex::Print() << "\n";
+}
+
+void
+TinyProfiler::RegisterReport (std::function<void()> f)
+{
+    reports.push_back(std::move(f));
 }
 
 void
@@ -594,15 +1065,16 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
 void
 TinyProfiler::StartRegion (std::string regname) noexcept
 {
-    if (std::find(regionstack.begin(), regionstack.end(), regname) == regionstack.end()) {
-        regionstack.emplace_back(std::move(regname));
+    const int id = region_registry().intern(regname);
+    if (std::find(regionstack.begin(), regionstack.end(), id) == regionstack.end()) {
+        regionstack.push_back(id);
     }
 }
 
 void
 TinyProfiler::StopRegion (const std::string& regname) noexcept
 {
-    if (regname == regionstack.back()) {
+    if (!regionstack.empty() && region_registry().intern(regname) == regionstack.back()) {
         regionstack.pop_back();
     }
 }
@@ -629,12 +1101,41 @@ TinyProfileRegion::~TinyProfileRegion ()
     TinyProfiler::StopRegion(regname);
 }
 
+void
+TinyProfiler::GetCallPath (std::vector<int>& ids)
+{
+    ids.push_back(regionstack.empty() ? -1 : regionstack.back());
+    for (auto const& x : GetThreadData()->ttstack) {
+        ids.push_back(x.id);
+    }
+}
+
+std::string
+TinyProfiler::CallPathName (std::vector<int> const& ids)
+{
+    if (ids.empty() || ids[0] < 0) {
+        return std::string("(not profiled)");
+    }
+    std::string r = region_registry().name(ids[0]) + ":";
+    for (std::size_t i = 1; i < ids.size(); ++i) {
+        r += ((i == 1) ? " " : " -> ") + timer_registry().name(ids[i]);
+    }
+    return r;
+}
+
 void
 TinyProfiler::PrintCallStack (std::ostream& os)
 {
     os << "===== TinyProfilers ======\n";
-    for (auto const& x : ttstack) {
-        os << *(std::get<2>(x)) << "\n";
+    auto& reg = timer_registry();
+    for (auto const& x : GetThreadData()->ttstack) {
+        // This may be called from a signal handler, so do not wait for the lock.
+        if (reg.mutex.try_lock()) {
+            os << reg.names[x.id] << "\n";
+            reg.mutex.unlock();
+        } else {
+            os << "timer " << x.id << "\n";
+        }
     }
 }
 
@@ -7,6 +7,7 @@
 
 #include <cerrno>
 #include <cstdio>
+#include <iomanip>
 #include <limits>
 
 namespace amrex {
@@ -40,6 +41,110 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    bool collectTelemetry = false;
+    VisMF::WriteTelemetry writeTelemetry;
+
+    //
+    // Per configuration (nOutFiles, dynamic set selection) statistics.
+    //
+    struct NFilesConfigStats
+    {
+        Long   nWrites  = 0;
+        Long   nBytes   = 0;
+        double wallTime = 0.0;
+    };
+    std::map<std::pair<int,bool>, NFilesConfigStats> configStats;
+
+    //
+    // The auto-tuner is a hill climb over nOutFiles and the set selection
+    // policy.  After each write that is large enough, the neighbors of the
+    // best configuration measured so far (twice and half the number of files,
+    // and the other set selection policy) are tried one at a time until none
+    // of them is faster.  All processes see the same reduced bandwidths, so
+    // they make the same decisions.  The measurements are discarded every
+    // autoTuneInterval writes to follow changes in the system load.
+    //
+    bool autoTuneNFiles = false;
+    Long autoTuneMinBytes = 1024*1024;
+    int  autoTuneInterval = 20;
+    int  autoTuneWrites = 0;
+    std::map<std::pair<int,bool>, double> tunedBandwidth;
+
+    std::pair<int,bool> currentNFilesConfig ()
+    {
+        int nfiles = NFilesIter::ActualNFiles(VisMF::GetNOutFiles());
+        bool dynamic = VisMF::GetUseDynamicSetSelection() && nfiles < ParallelDescriptor::NProcs();
+        return std::make_pair(nfiles, dynamic);
+    }
+
+    void autoTune (std::pair<int,bool> const& config, double bandwidth)
+    {
+        if (++autoTuneWrites > autoTuneInterval) {
+            autoTuneWrites = 1;
+            tunedBandwidth.clear();
+        }
+        tunedBandwidth[config] = bandwidth;
+
+        auto best = tunedBandwidth.begin();
+        for (auto it = tunedBandwidth.begin(); it != tunedBandwidth.end(); ++it) {
+            if (it->second > best->second) { best = it; }
+        }
+
+        const int nprocs = ParallelDescriptor::NProcs();
+        const int nfiles = best->first.first;
+        const bool dynamic = best->first.second;
+        std::pair<int,bool> candidates[3] = {
+            std::make_pair(std::min(2*nfiles, nprocs), dynamic),
+            std::make_pair(std::max(nfiles/2, 1), dynamic),
+            std::make_pair(nfiles, !dynamic)
+        };
+        std::pair<int,bool> next = best->first;
+        for (auto const& c : candidates) {
+            bool valid = !(c.second && c.first >= nprocs);  // ---- NFilesIter uses static selection then
+            if (valid && tunedBandwidth.count(c) == 0) {
+                next = c;
+                break;
+            }
+        }
+
+        if (next != config && VisMF::GetVerbose() > 0) {
+            amrex::Print() << "VisMF auto-tuner:  nOutFiles = " << next.first
+                           << "  dynamic set selection = " << next.second << '\n';
+        }
+        VisMF::SetNOutFiles(next.first);
+        VisMF::SetUseDynamicSetSelection(next.second);
+    }
+
+    void recordWrite (NFilesIter::WriteStats const& stats0, double wallTime)
+    {
+        NFilesIter::WriteStats const& stats1 = NFilesIter::GetWriteStats();
+        Long nBytes = stats1.nBytes - stats0.nBytes;
+        double times[3] = { wallTime,
+                            stats1.waitTime  - stats0.waitTime,
+                            stats1.writeTime - stats0.writeTime };
+        ParallelDescriptor::ReduceLongSum(nBytes);
+        ParallelDescriptor::ReduceRealMax(times, 3);
+
+        const double bandwidth = (times[0] > 0.0) ? double(nBytes) / times[0] : 0.0;
+
+        ++writeTelemetry.nWrites;
+        writeTelemetry.nBytes        += nBytes;
+        writeTelemetry.wallTime      += times[0];
+        writeTelemetry.maxWaitTime   += times[1];
+        writeTelemetry.maxWriteTime  += times[2];
+        writeTelemetry.lastBandwidth  = bandwidth;
+
+        auto config = currentNFilesConfig();
+        NFilesConfigStats& cs = configStats[config];
+        ++cs.nWrites;
+        cs.nBytes   += nBytes;
+        cs.wallTime += times[0];
+
+        if (autoTuneNFiles && nBytes >= autoTuneMinBytes) {
+            autoTune(config, bandwidth);
+        }
+    }
 }
 
 void
@@ -77,6 +182,20 @@ VisMF::Initialize ()
     pp.queryAdd("iobuffersize", ioBufferSize);
     pp.queryAdd("allowsparsewrites", allowSparseWrites);
 
+    int telemetry(0);
+    pp.queryAdd("telemetry", telemetry);
+    pp.queryAdd("autotune_nfiles", autoTuneNFiles);
+    pp.queryAdd("autotune_min_bytes", autoTuneMinBytes);
+    pp.queryAdd("autotune_interval", autoTuneInterval);
+    autoTuneInterval = std::max(autoTuneInterval, 1);
+    collectTelemetry = telemetry || autoTuneNFiles;
+
+#ifdef AMREX_TINY_PROFILING
+    if (collectTelemetry) {
+        TinyProfiler::RegisterReport(VisMF::PrintWriteTelemetry);
+    }
+#endif
+
     initialized = true;
 }
 
@@ -104,6 +223,48 @@ VisMF::GetNOutFiles()
     return nOutFiles;
 }
 
+const VisMF::WriteTelemetry&
+VisMF::GetWriteTelemetry ()
+{
+    return writeTelemetry;
+}
+
+void
+VisMF::PrintWriteTelemetry ()
+{
+    if (writeTelemetry.nWrites == 0) {
+        return;
+    }
+
+    constexpr double MB = 1024.0*1024.0;
+    auto const& wt = writeTelemetry;
+    amrex::Print() << "\nVisMF::Write telemetry:\n"
+                   << "  writes:  " << wt.nWrites
+                   << "  MB:  " << double(wt.nBytes)/MB
+                   << "  time:  " << wt.wallTime
+                   << "  MB/s:  " << ((wt.wallTime > 0.0) ? double(wt.nBytes)/MB/wt.wallTime : 0.0)
+                   << "\n  max time waiting for the set token:  " << wt.maxWaitTime
+                   << "  max time writing:  " << wt.maxWriteTime << '\n';
+
+    amrex::Print() << "  " << std::setw(8) << "nfiles" << std::setw(9) << "dynamic"
+                   << std::setw(9) << "writes" << std::setw(14) << "MB"
+                   << std::setw(12) << "MB/s" << '\n';
+    for (auto const& kv : configStats) {
+        auto const& cs = kv.second;
+        amrex::Print() << "  " << std::setw(8) << kv.first.first
+                       << std::setw(9) << kv.first.second
+                       << std::setw(9) << cs.nWrites
+                       << std::setw(14) << double(cs.nBytes)/MB
+                       << std::setw(12) << ((cs.wallTime > 0.0) ? double(cs.nBytes)/MB/cs.wallTime : 0.0)
+                       << '\n';
+    }
+    if (autoTuneNFiles) {
+        auto config = currentNFilesConfig();
+        amrex::Print() << "  auto-tuner:  nOutFiles = " << config.first
+                       << "  dynamic set selection = " << config.second << '\n';
+    }
+}
+
 std::ostream&
 operator<< (std::ostream& os, const VisMF::FabOnDisk& fod)
 {
@@ -924,6 +1085,9 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     BL_ASSERT(mf_name[mf_name.length() - 1] != '/');
     BL_ASSERT(currentVersion != VisMF::Header::Undefined_v1);
 
+    const NFilesIter::WriteStats stats0(NFilesIter::GetWriteStats());
+    const double startTime(amrex::second());
+
     // ---- add stream retry
     // ---- add stream buffer (to nfiles)
     auto whichRD = FArrayBox::getDataDescriptor();
@@ -1106,6 +1270,10 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
 
     bytesWritten += VisMF::WriteHeader(mf_name, hdr, coordinatorProc);
 
+    if(collectTelemetry) {
+        recordWrite(stats0, amrex::second() - startTime);
+    }
+
     return bytesWritten;
 }
 
@@ -2332,6 +2500,15 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
     }
 #endif
 
+    // Reserve room in the staging pool before making copies.  This may block
+    // until earlier writes have drained.
+    Long staging_bytes = 0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        Box bx = strip_ghost ? mfi.validbox() : mfi.fabbox();
+        staging_bytes += bx.numPts() * ncomp * Long(sizeof(Real));
+    }
+    AsyncOut::AcquireStaging(staging_bytes);
+
     auto myfabs = std::make_shared<Vector<FArrayBox> >();
     for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
         Box bx = strip_ghost ? mfi.validbox() : mfi.fabbox();
@@ -2461,6 +2638,9 @@ VisMF::AsyncWriteDoit (const FabArray<FArrayBox>& mf, const std::string& mf_name
             ofs.close();
         }
 
+        myfabs->clear();
+        AsyncOut::ReleaseStaging(staging_bytes);
+
         AsyncOut::Notify();  // Notify others I am done
     });
 }
@@ -83,6 +83,14 @@ Parser::print () const
     }
 }
 
+void
+Parser::compileNative () const
+{
+    if (parser_jit_enabled()) {
+        m_data->m_host_native = parser_jit(m_data->m_parser, m_data->m_expression);
+    }
+}
+
 int
 Parser::depth () const
 {
@@ -113,6 +121,19 @@ Parser::expr () const
     }
 }
 
+Parser
+Parser::derivative (std::string const& var) const
+{
+    Parser r;
+    if (m_data && m_data->m_parser) {
+        r.m_data = std::make_shared<Data>();
+        r.m_data->m_expression = "d(" + m_data->m_expression + ")/d" + var;
+        r.m_data->m_parser = parser_derivative(m_data->m_parser, var.c_str());
+        r.m_data->m_nvars = m_data->m_nvars;
+    }
+    return r;
+}
+
 std::set<std::string>
 Parser::symbols () const
 {
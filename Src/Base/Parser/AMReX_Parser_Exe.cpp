@@ -1,5 +1,8 @@
 #include <AMReX_Parser_Exe.H>
 
+#include <memory>
+#include <utility>
+
 namespace amrex {
 
 static int parser_local_symbol_index (struct parser_symbol* sym, Vector<char*>& local_variables)
@@ -742,4 +745,437 @@ parser_compile_exe_size (struct parser_node* node, char*& p, std::size_t& exe_si
     }
 }
 
+namespace {
+
+constexpr int parser_bw = AMREX_PARSER_BATCH_SIZE;
+
+struct ParserBatchStack
+{
+    double m_data[AMREX_PARSER_STACK_SIZE][parser_bw];
+    int m_size = 0;
+    double* push () { return m_data[m_size++]; }
+    void pop () { --m_size; }
+    double* top () { return m_data[m_size-1]; }
+    double* operator[] (int i) { return m_data[i]; }
+};
+
+// The stacks are too big for the call stack, so each thread keeps one per
+// level of nested divergent ifs and reuses them for every batch.
+struct ParserBatchWorkspace
+{
+    Vector<std::unique_ptr<ParserBatchStack>> m_stacks;
+    Vector<Vector<double>> m_x;
+    int m_depth = 0;
+
+    ParserBatchStack& stack (int depth)
+    {
+        while (depth >= static_cast<int>(m_stacks.size())) {
+            m_stacks.push_back(std::make_unique<ParserBatchStack>());
+            m_x.emplace_back();
+        }
+        m_stacks[depth]->m_size = 0;
+        return *m_stacks[depth];
+    }
+};
+
+ParserBatchWorkspace& parser_batch_workspace ()
+{
+    static thread_local ParserBatchWorkspace ws;
+    return ws;
+}
+
+#define AMREX_PARSER_BATCH_DATA(i) ((i)>=AMREX_PARSER_LOCAL_IDX0) \
+    ? pstack[(i)-AMREX_PARSER_LOCAL_IDX0] : x+(i)*parser_bw
+
+// Calling parser_call_f1/f2 with a constant type lets the compiler remove the
+// switch from the loop.
+#define AMREX_PARSER_BATCH_F1(T) \
+    case T: for (int l = 0; l < n; ++l) { a[l] = parser_call_f1(T, a[l]); } break
+
+#define AMREX_PARSER_BATCH_F2(T) \
+    case T: for (int l = 0; l < n; ++l) { a[l] = parser_call_f2(T, a[l], b[l]); } break
+
+void parser_batch_f1 (parser_f1_t type, int n, double* AMREX_RESTRICT a)
+{
+    switch (type) {
+    AMREX_PARSER_BATCH_F1(PARSER_SQRT);
+    AMREX_PARSER_BATCH_F1(PARSER_EXP);
+    AMREX_PARSER_BATCH_F1(PARSER_LOG);
+    AMREX_PARSER_BATCH_F1(PARSER_LOG10);
+    AMREX_PARSER_BATCH_F1(PARSER_SIN);
+    AMREX_PARSER_BATCH_F1(PARSER_COS);
+    AMREX_PARSER_BATCH_F1(PARSER_TAN);
+    AMREX_PARSER_BATCH_F1(PARSER_ASIN);
+    AMREX_PARSER_BATCH_F1(PARSER_ACOS);
+    AMREX_PARSER_BATCH_F1(PARSER_ATAN);
+    AMREX_PARSER_BATCH_F1(PARSER_SINH);
+    AMREX_PARSER_BATCH_F1(PARSER_COSH);
+    AMREX_PARSER_BATCH_F1(PARSER_TANH);
+    AMREX_PARSER_BATCH_F1(PARSER_ABS);
+    AMREX_PARSER_BATCH_F1(PARSER_FLOOR);
+    AMREX_PARSER_BATCH_F1(PARSER_CEIL);
+    AMREX_PARSER_BATCH_F1(PARSER_POW_M3);
+    AMREX_PARSER_BATCH_F1(PARSER_POW_M2);
+    AMREX_PARSER_BATCH_F1(PARSER_POW_M1);
+    AMREX_PARSER_BATCH_F1(PARSER_POW_P1);
+    AMREX_PARSER_BATCH_F1(PARSER_POW_P2);
+    AMREX_PARSER_BATCH_F1(PARSER_POW_P3);
+    AMREX_PARSER_BATCH_F1(PARSER_POW_HALF);
+    default:
+        amrex::Abort("parser_exe_eval_batch: Unknown function");
+    }
+}
+
+void parser_batch_f2 (parser_f2_t type, int n, double* AMREX_RESTRICT a,
+                      double const* AMREX_RESTRICT b)
+{
+    switch (type) {
+    AMREX_PARSER_BATCH_F2(PARSER_POW);
+    AMREX_PARSER_BATCH_F2(PARSER_GT);
+    AMREX_PARSER_BATCH_F2(PARSER_LT);
+    AMREX_PARSER_BATCH_F2(PARSER_GEQ);
+    AMREX_PARSER_BATCH_F2(PARSER_LEQ);
+    AMREX_PARSER_BATCH_F2(PARSER_EQ);
+    AMREX_PARSER_BATCH_F2(PARSER_NEQ);
+    AMREX_PARSER_BATCH_F2(PARSER_AND);
+    AMREX_PARSER_BATCH_F2(PARSER_OR);
+    AMREX_PARSER_BATCH_F2(PARSER_HEAVISIDE);
+    AMREX_PARSER_BATCH_F2(PARSER_JN);
+    AMREX_PARSER_BATCH_F2(PARSER_MIN);
+    AMREX_PARSER_BATCH_F2(PARSER_MAX);
+    AMREX_PARSER_BATCH_F2(PARSER_FMOD);
+    default:
+        amrex::Abort("parser_exe_eval_batch: Unknown function");
+    }
+}
+
+#undef AMREX_PARSER_BATCH_F1
+#undef AMREX_PARSER_BATCH_F2
+
+// Runs the byte code from p until pend or the end of the code.
+void parser_batch_run (char const* p, char const* pend, int nvars, int n,
+                       double const* x, ParserBatchStack& pstack);
+
+// Evaluates an if on a subset of the lanes.  The selected lanes of the stack
+// and the variables are gathered, the branch is run on them and its result
+// is scattered back to the new top of pstack.
+void parser_batch_branch (char const* p, char const* pend, int nvars, int m,
+                          int const* lanes, double const* x, ParserBatchStack& pstack,
+                          double* result)
+{
+    auto& ws = parser_batch_workspace();
+    const int depth = ++ws.m_depth;
+    auto& sub = ws.stack(depth);
+    sub.m_size = pstack.m_size;
+    for (int i = 0; i < pstack.m_size; ++i) {
+        for (int l = 0; l < m; ++l) { sub.m_data[i][l] = pstack.m_data[i][lanes[l]]; }
+    }
+    auto& subx = ws.m_x[depth];
+    subx.resize(std::size_t(nvars)*parser_bw);
+    for (int i = 0; i < nvars; ++i) {
+        for (int l = 0; l < m; ++l) { subx[i*parser_bw+l] = x[i*parser_bw+lanes[l]]; }
+    }
+    parser_batch_run(p, pend, nvars, m, subx.data(), sub);
+    double const* r = sub.top();
+    for (int l = 0; l < m; ++l) { result[lanes[l]] = r[l]; }
+    --ws.m_depth;
+}
+
+void parser_batch_run (char const* p, char const* pend, int nvars, int n,
+                       double const* x, ParserBatchStack& pstack)
+{
+    while (p != pend && *((parser_exe_t*)p) != PARSER_EXE_NULL) {
+        switch (*((parser_exe_t*)p))
+        {
+        case PARSER_EXE_NUMBER:
+        {
+            double v = ((ParserExeNumber*)p)->v;
+            double* AMREX_RESTRICT a = pstack.push();
+            for (int l = 0; l < n; ++l) { a[l] = v; }
+            p += sizeof(ParserExeNumber);
+            break;
+        }
+        case PARSER_EXE_SYMBOL:
+        {
+            int i = ((ParserExeSymbol*)p)->i;
+            double const* AMREX_RESTRICT d = AMREX_PARSER_BATCH_DATA(i);
+            double* AMREX_RESTRICT a = pstack.push();
+            for (int l = 0; l < n; ++l) { a[l] = d[l]; }
+            p += sizeof(ParserExeSymbol);
+            break;
+        }
+        case PARSER_EXE_ADD:
+        {
+            double const* AMREX_RESTRICT b = pstack.top();
+            pstack.pop();
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] += b[l]; }
+            p += sizeof(ParserExeADD);
+            break;
+        }
+        case PARSER_EXE_SUB:
+        {
+            double sign = ((ParserExeSUB*)p)->sign;
+            double const* AMREX_RESTRICT b = pstack.top();
+            pstack.pop();
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] = (a[l] - b[l]) * sign; }
+            p += sizeof(ParserExeSUB);
+            break;
+        }
+        case PARSER_EXE_MUL:
+        {
+            double const* AMREX_RESTRICT b = pstack.top();
+            pstack.pop();
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] *= b[l]; }
+            p += sizeof(ParserExeMUL);
+            break;
+        }
+        case PARSER_EXE_DIV_F:
+        {
+            double const* AMREX_RESTRICT b = pstack.top();
+            pstack.pop();
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] /= b[l]; }
+            p += sizeof(ParserExeDIV_F);
+            break;
+        }
+        case PARSER_EXE_DIV_B:
+        {
+            double const* AMREX_RESTRICT b = pstack.top();
+            pstack.pop();
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] = b[l] / a[l]; }
+            p += sizeof(ParserExeDIV_B);
+            break;
+        }
+        case PARSER_EXE_NEG:
+        {
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] = -a[l]; }
+            p += sizeof(ParserExeNEG);
+            break;
+        }
+        case PARSER_EXE_F1:
+        {
+            parser_batch_f1(((ParserExeF1*)p)->ftype, n, pstack.top());
+            p += sizeof(ParserExeF1);
+            break;
+        }
+        case PARSER_EXE_F2_F:
+        {
+            double const* b = pstack.top();
+            pstack.pop();
+            parser_batch_f2(((ParserExeF2_F*)p)->ftype, n, pstack.top(), b);
+            p += sizeof(ParserExeF2_F);
+            break;
+        }
+        case PARSER_EXE_F2_B:
+        {
+            // f(top, top-1) is stored in top-1.
+            double* AMREX_RESTRICT b = pstack.top();
+            pstack.pop();
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { std::swap(a[l], b[l]); }
+            parser_batch_f2(((ParserExeF2_B*)p)->ftype, n, a, b);
+            p += sizeof(ParserExeF2_B);
+            break;
+        }
+        case PARSER_EXE_ADD_VP:
+        case PARSER_EXE_SUB_VP:
+        case PARSER_EXE_MUL_VP:
+        case PARSER_EXE_DIV_VP:
+        {
+            // The VP instructions have the same layout.
+            auto t = *((parser_exe_t*)p);
+            double v = ((ParserExeADD_VP*)p)->v;
+            int i = ((ParserExeADD_VP*)p)->i;
+            double const* AMREX_RESTRICT d = AMREX_PARSER_BATCH_DATA(i);
+            double* AMREX_RESTRICT a = pstack.push();
+            if (t == PARSER_EXE_ADD_VP) {
+                for (int l = 0; l < n; ++l) { a[l] = v + d[l]; }
+            } else if (t == PARSER_EXE_SUB_VP) {
+                for (int l = 0; l < n; ++l) { a[l] = v - d[l]; }
+            } else if (t == PARSER_EXE_MUL_VP) {
+                for (int l = 0; l < n; ++l) { a[l] = v * d[l]; }
+            } else {
+                for (int l = 0; l < n; ++l) { a[l] = v / d[l]; }
+            }
+            p += sizeof(ParserExeADD_VP);
+            break;
+        }
+        case PARSER_EXE_ADD_PP:
+        case PARSER_EXE_SUB_PP:
+        case PARSER_EXE_MUL_PP:
+        case PARSER_EXE_DIV_PP:
+        {
+            // The PP instructions have the same layout.
+            auto t = *((parser_exe_t*)p);
+            int i1 = ((ParserExeADD_PP*)p)->i1;
+            int i2 = ((ParserExeADD_PP*)p)->i2;
+            double const* AMREX_RESTRICT d1 = AMREX_PARSER_BATCH_DATA(i1);
+            double const* AMREX_RESTRICT d2 = AMREX_PARSER_BATCH_DATA(i2);
+            double* AMREX_RESTRICT a = pstack.push();
+            if (t == PARSER_EXE_ADD_PP) {
+                for (int l = 0; l < n; ++l) { a[l] = d1[l] + d2[l]; }
+            } else if (t == PARSER_EXE_SUB_PP) {
+                for (int l = 0; l < n; ++l) { a[l] = d1[l] - d2[l]; }
+            } else if (t == PARSER_EXE_MUL_PP) {
+                for (int l = 0; l < n; ++l) { a[l] = d1[l] * d2[l]; }
+            } else {
+                for (int l = 0; l < n; ++l) { a[l] = d1[l] / d2[l]; }
+            }
+            p += sizeof(ParserExeADD_PP);
+            break;
+        }
+        case PARSER_EXE_NEG_P:
+        {
+            int i = ((ParserExeNEG_P*)p)->i;
+            double const* AMREX_RESTRICT d = AMREX_PARSER_BATCH_DATA(i);
+            double* AMREX_RESTRICT a = pstack.push();
+            for (int l = 0; l < n; ++l) { a[l] = -d[l]; }
+            p += sizeof(ParserExeNEG_P);
+            break;
+        }
+        case PARSER_EXE_ADD_VN:
+        {
+            double v = ((ParserExeADD_VN*)p)->v;
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] += v; }
+            p += sizeof(ParserExeADD_VN);
+            break;
+        }
+        case PARSER_EXE_SUB_VN:
+        {
+            double v = ((ParserExeSUB_VN*)p)->v;
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] = v - a[l]; }
+            p += sizeof(ParserExeSUB_VN);
+            break;
+        }
+        case PARSER_EXE_MUL_VN:
+        {
+            double v = ((ParserExeMUL_VN*)p)->v;
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] *= v; }
+            p += sizeof(ParserExeMUL_VN);
+            break;
+        }
+        case PARSER_EXE_DIV_VN:
+        {
+            double v = ((ParserExeDIV_VN*)p)->v;
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] = v / a[l]; }
+            p += sizeof(ParserExeDIV_VN);
+            break;
+        }
+        case PARSER_EXE_ADD_PN:
+        {
+            int i = ((ParserExeADD_PN*)p)->i;
+            double const* AMREX_RESTRICT d = AMREX_PARSER_BATCH_DATA(i);
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] += d[l]; }
+            p += sizeof(ParserExeADD_PN);
+            break;
+        }
+        case PARSER_EXE_SUB_PN:
+        {
+            int i = ((ParserExeSUB_PN*)p)->i;
+            double sign = ((ParserExeSUB_PN*)p)->sign;
+            double const* AMREX_RESTRICT d = AMREX_PARSER_BATCH_DATA(i);
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] = (d[l] - a[l]) * sign; }
+            p += sizeof(ParserExeSUB_PN);
+            break;
+        }
+        case PARSER_EXE_MUL_PN:
+        {
+            int i = ((ParserExeMUL_PN*)p)->i;
+            double const* AMREX_RESTRICT d = AMREX_PARSER_BATCH_DATA(i);
+            double* AMREX_RESTRICT a = pstack.top();
+            for (int l = 0; l < n; ++l) { a[l] *= d[l]; }
+            p += sizeof(ParserExeMUL_PN);
+            break;
+        }
+        case PARSER_EXE_DIV_PN:
+        {
+            int i = ((ParserExeDIV_PN*)p)->i;
+            double const* AMREX_RESTRICT d = AMREX_PARSER_BATCH_DATA(i);
+            double* AMREX_RESTRICT a = pstack.top();
+            if (((ParserExeDIV_PN*)p)->reverse) {
+                for (int l = 0; l < n; ++l) { a[l] /= d[l]; }
+            } else {
+                for (int l = 0; l < n; ++l) { a[l] = d[l] / a[l]; }
+            }
+            p += sizeof(ParserExeDIV_PN);
+            break;
+        }
+        case PARSER_EXE_IF:
+        {
+            // The true branch ends with a JUMP over the false branch.
+            char const* ptrue = p + sizeof(ParserExeIF);
+            char const* pfalse = ptrue + ((ParserExeIF*)p)->offset;
+            char const* pjump = pfalse - sizeof(ParserExeJUMP);
+            char const* pnext = pfalse + ((ParserExeJUMP*)pjump)->offset;
+
+            double const* cond = pstack.top();
+            pstack.pop();
+            int lanes_true[parser_bw];
+            int lanes_false[parser_bw];
+            int ntrue = 0, nfalse = 0;
+            for (int l = 0; l < n; ++l) {
+                if (cond[l] == 0.0) {
+                    lanes_false[nfalse++] = l;
+                } else {
+                    lanes_true[ntrue++] = l;
+                }
+            }
+
+            if (nfalse == 0) {
+                p = ptrue;
+            } else if (ntrue == 0) {
+                p = pfalse;
+            } else {
+                // The lanes disagree.  Run each branch only on its own lanes,
+                // so that, e.g., sqrt is never called on a guarded negative.
+                double result[parser_bw];
+                parser_batch_branch(ptrue, pjump, nvars, ntrue, lanes_true, x, pstack,
+                                    result);
+                parser_batch_branch(pfalse, pnext, nvars, nfalse, lanes_false, x, pstack,
+                                    result);
+                double* AMREX_RESTRICT a = pstack.push();
+                for (int l = 0; l < n; ++l) { a[l] = result[l]; }
+                p = pnext;
+            }
+            break;
+        }
+        case PARSER_EXE_JUMP:
+        {
+            int offset = ((ParserExeJUMP*)p)->offset;
+            p += sizeof(ParserExeJUMP) + offset;
+            break;
+        }
+        default:
+            amrex::Abort("parser_exe_eval_batch: unknown node type");
+        }
+    }
+}
+
+#undef AMREX_PARSER_BATCH_DATA
+
+}
+
+void
+parser_exe_eval_batch (char const* p, int nvars, int n, double const* x, double* r)
+{
+    AMREX_ASSERT(n <= AMREX_PARSER_BATCH_SIZE);
+    auto& ws = parser_batch_workspace();
+    AMREX_ASSERT(ws.m_depth == 0);
+    auto& pstack = ws.stack(0);
+    parser_batch_run(p, nullptr, nvars, n, x, pstack);
+    double const* a = pstack.top();
+    for (int l = 0; l < n; ++l) { r[l] = a[l]; }
+}
+
 }
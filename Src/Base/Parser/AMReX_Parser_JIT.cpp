@@ -0,0 +1,396 @@
+#include <AMReX_Parser_JIT.H>
+#include <AMReX.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#include <unistd.h>
+#define AMREX_PARSER_USE_DLOPEN 1
+#endif
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace amrex {
+
+namespace {
+
+struct ParserJITParams
+{
+    bool enabled = false;
+    bool verbose = false;
+    std::string cxx;
+    std::string flags = "-O3 -fPIC -shared";
+    std::string cache = "amrex_parser_cache";
+};
+
+ParserJITParams const& parser_jit_params ()
+{
+    static ParserJITParams const params = [] () {
+        ParserJITParams p;
+        char const* cxx = std::getenv("CXX");
+        p.cxx = (cxx != nullptr) ? cxx : "c++";
+        if (amrex::Initialized()) {
+            ParmParse pp("amrex");
+            pp.queryAdd("parser_jit", p.enabled);
+            pp.queryAdd("parser_jit_verbose", p.verbose);
+            pp.queryAdd("parser_jit_cxx", p.cxx);
+            pp.queryAdd("parser_jit_flags", p.flags);
+            pp.queryAdd("parser_jit_cache", p.cache);
+        }
+        return p;
+    }();
+    return params;
+}
+
+std::string parser_cpp_number (double v)
+{
+    if (std::isnan(v)) {
+        return "std::numeric_limits<double>::quiet_NaN()";
+    } else if (std::isinf(v)) {
+        return (v > 0) ? "std::numeric_limits<double>::infinity()"
+                       : "(-std::numeric_limits<double>::infinity())";
+    } else {
+        // Hexadecimal floating point literals are exact.
+        std::ostringstream ss;
+        ss << std::hexfloat << v;
+        return "(" + ss.str() + ")";
+    }
+}
+
+char const* parser_cpp_f1 (enum parser_f1_t type)
+{
+    switch (type) {
+    case PARSER_SQRT:   return "std::sqrt";
+    case PARSER_EXP:    return "std::exp";
+    case PARSER_LOG:    return "std::log";
+    case PARSER_LOG10:  return "std::log10";
+    case PARSER_SIN:    return "std::sin";
+    case PARSER_COS:    return "std::cos";
+    case PARSER_TAN:    return "std::tan";
+    case PARSER_ASIN:   return "std::asin";
+    case PARSER_ACOS:   return "std::acos";
+    case PARSER_ATAN:   return "std::atan";
+    case PARSER_SINH:   return "std::sinh";
+    case PARSER_COSH:   return "std::cosh";
+    case PARSER_TANH:   return "std::tanh";
+    case PARSER_ABS:    return "std::abs";
+    case PARSER_FLOOR:  return "std::floor";
+    case PARSER_CEIL:   return "std::ceil";
+    case PARSER_POW_M3: return "amrex_pow_m3";
+    case PARSER_POW_M2: return "amrex_pow_m2";
+    case PARSER_POW_M1: return "amrex_pow_m1";
+    case PARSER_POW_P1: return "";
+    case PARSER_POW_P2: return "amrex_pow_p2";
+    case PARSER_POW_P3: return "amrex_pow_p3";
+    case PARSER_POW_HALF: return "amrex_pow_half";
+    default:
+        amrex::Abort("parser_to_cpp: unknown f1 type");
+        return "";
+    }
+}
+
+char const* parser_cpp_f2 (enum parser_f2_t type)
+{
+    switch (type) {
+    case PARSER_POW:       return "std::pow";
+    case PARSER_GT:        return "amrex_gt";
+    case PARSER_LT:        return "amrex_lt";
+    case PARSER_GEQ:       return "amrex_geq";
+    case PARSER_LEQ:       return "amrex_leq";
+    case PARSER_EQ:        return "amrex_eq";
+    case PARSER_NEQ:       return "amrex_neq";
+    case PARSER_AND:       return "amrex_and";
+    case PARSER_OR:        return "amrex_or";
+    case PARSER_HEAVISIDE: return "amrex_heaviside";
+    case PARSER_JN:        return "amrex_jn";
+    case PARSER_MIN:       return "amrex_min";
+    case PARSER_MAX:       return "amrex_max";
+    case PARSER_FMOD:      return "std::fmod";
+    default:
+        amrex::Abort("parser_to_cpp: unknown f2 type");
+        return "";
+    }
+}
+
+// The built-in functions, with the same semantics as parser_call_f1/f2.
+constexpr char const* parser_cpp_preamble = R"(#include <cmath>
+#include <limits>
+
+namespace {
+inline double amrex_pow_m3 (double a) { return 1.0/(a*a*a); }
+inline double amrex_pow_m2 (double a) { return 1.0/(a*a); }
+inline double amrex_pow_m1 (double a) { return 1.0/a; }
+inline double amrex_pow_p2 (double a) { return a*a; }
+inline double amrex_pow_p3 (double a) { return a*a*a; }
+inline double amrex_pow_half (double a) {
+    return (a == 0.0) ? 0.0 : ((a == -std::numeric_limits<double>::infinity())
+                               ? std::numeric_limits<double>::infinity() : std::sqrt(a));
+}
+inline double amrex_gt  (double a, double b) { return (a >  b) ? 1.0 : 0.0; }
+inline double amrex_lt  (double a, double b) { return (a <  b) ? 1.0 : 0.0; }
+inline double amrex_geq (double a, double b) { return (a >= b) ? 1.0 : 0.0; }
+inline double amrex_leq (double a, double b) { return (a <= b) ? 1.0 : 0.0; }
+inline double amrex_eq  (double a, double b) { return (a == b) ? 1.0 : 0.0; }
+inline double amrex_neq (double a, double b) { return (a != b) ? 1.0 : 0.0; }
+inline double amrex_and (double a, double b) { return ((a != 0.0) && (b != 0.0)) ? 1.0 : 0.0; }
+inline double amrex_or  (double a, double b) { return ((a != 0.0) || (b != 0.0)) ? 1.0 : 0.0; }
+inline double amrex_heaviside (double a, double b) { return (a < 0.0) ? 0.0 : ((a > 0.0) ? 1.0 : b); }
+inline double amrex_jn  (double a, double b) { return jn(int(a), b); }
+inline double amrex_min (double a, double b) { return (a < b) ? a : b; }
+inline double amrex_max (double a, double b) { return (a > b) ? a : b; }
+}
+)";
+
+//! Emits local variables as statements and returns everything else as expressions.
+struct ParserCppGen
+{
+    std::ostringstream stmts;
+    std::vector<std::pair<std::string,std::string> > locals; // parser name, C++ name
+
+    std::string symbol (struct parser_node* node)
+    {
+        auto sym = (struct parser_symbol*)node;
+        for (auto it = locals.rbegin(); it != locals.rend(); ++it) {
+            if (it->first == sym->name) { return it->second; }
+        }
+        if (sym->ip < 0) {
+            throw std::runtime_error(std::string("Unknown variable ") + sym->name);
+        }
+        return "x[" + std::to_string(sym->ip) + "]";
+    }
+
+    std::string binary (std::string const& a, char op, std::string const& b)
+    {
+        return "(" + a + " " + op + " " + b + ")";
+    }
+
+    std::string expr (struct parser_node* node)
+    {
+        switch (node->type)
+        {
+        case PARSER_NUMBER:
+            return parser_cpp_number(((struct parser_number*)node)->value);
+        case PARSER_SYMBOL:
+            return symbol(node);
+        case PARSER_ADD:
+            return binary(expr(node->l), '+', expr(node->r));
+        case PARSER_SUB:
+            return binary(expr(node->l), '-', expr(node->r));
+        case PARSER_MUL:
+            return binary(expr(node->l), '*', expr(node->r));
+        case PARSER_DIV:
+            return binary(expr(node->l), '/', expr(node->r));
+        case PARSER_NEG:
+            return "(-" + expr(node->l) + ")";
+        case PARSER_F1:
+        {
+            auto f1 = (struct parser_f1*)node;
+            return std::string(parser_cpp_f1(f1->ftype)) + "(" + expr(f1->l) + ")";
+        }
+        case PARSER_F2:
+        {
+            auto f2 = (struct parser_f2*)node;
+            return std::string(parser_cpp_f2(f2->ftype)) + "(" + expr(f2->l) + ", "
+                + expr(f2->r) + ")";
+        }
+        case PARSER_F3:
+        {
+            auto f3 = (struct parser_f3*)node;
+            return "((" + expr(f3->n1) + " != 0.0) ? " + expr(f3->n2) + " : "
+                + expr(f3->n3) + ")";
+        }
+        case PARSER_ASSIGN:
+        {
+            auto asgn = (struct parser_assign*)node;
+            std::string v = expr(asgn->v);
+            std::string name = "v" + std::to_string(locals.size());
+            stmts << "    const double " << name << " = " << v << ";\n";
+            locals.emplace_back(asgn->s->name, name);
+            return name;
+        }
+        case PARSER_LIST:
+        {
+            std::string l = expr(node->l);
+            if (node->l->type != PARSER_ASSIGN) {
+                stmts << "    (void)" << l << ";\n";
+            }
+            return expr(node->r);
+        }
+        case PARSER_ADD_VP:
+            return binary(parser_cpp_number(node->lvp.v), '+', symbol(node->r));
+        case PARSER_SUB_VP:
+            return binary(parser_cpp_number(node->lvp.v), '-', symbol(node->r));
+        case PARSER_MUL_VP:
+            return binary(parser_cpp_number(node->lvp.v), '*', symbol(node->r));
+        case PARSER_DIV_VP:
+            return binary(parser_cpp_number(node->lvp.v), '/', symbol(node->r));
+        case PARSER_ADD_PP:
+            return binary(symbol(node->l), '+', symbol(node->r));
+        case PARSER_SUB_PP:
+            return binary(symbol(node->l), '-', symbol(node->r));
+        case PARSER_MUL_PP:
+            return binary(symbol(node->l), '*', symbol(node->r));
+        case PARSER_DIV_PP:
+            return binary(symbol(node->l), '/', symbol(node->r));
+        case PARSER_NEG_P:
+            return "(-" + symbol(node->l) + ")";
+        default:
+            amrex::Abort("parser_to_cpp: unknown node type " + std::to_string(node->type));
+            return "";
+        }
+    }
+};
+
+//! The expression as a C++ comment.  It may span several lines.
+std::string parser_cpp_comment (std::string const& expression)
+{
+    std::string r = "/* ";
+    for (std::size_t i = 0; i < expression.size(); ++i) {
+        r += expression[i];
+        if (expression[i] == '*' && i+1 < expression.size() && expression[i+1] == '/') {
+            r += ' ';
+        }
+    }
+    return r + " */";
+}
+
+#ifdef AMREX_PARSER_USE_DLOPEN
+//! A name that differs between all processes of all jobs that share the cache.
+std::string parser_process_name ()
+{
+    char host[256] = "";
+    if (gethostname(host, sizeof(host)) != 0) { host[0] = '\0'; }
+    host[sizeof(host)-1] = '\0';
+    return std::string(host) + "." + std::to_string(ParallelDescriptor::MyProc())
+        + "." + std::to_string(getpid());
+}
+#endif
+
+//! 64-bit FNV-1a, which unlike std::hash is the same in every run.
+std::uint64_t parser_hash (std::string const& s)
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+}
+
+bool
+parser_jit_enabled ()
+{
+#ifdef AMREX_PARSER_USE_DLOPEN
+    return parser_jit_params().enabled;
+#else
+    return false;
+#endif
+}
+
+std::string
+parser_to_cpp (struct amrex_parser* parser, std::string const& fname)
+{
+    ParserCppGen gen;
+    std::string r = gen.expr(parser->ast);
+    std::ostringstream ss;
+    ss << parser_cpp_preamble << "\nextern \"C\" double " << fname
+       << " (double const* x)\n{\n    (void)x;\n" << gen.stmts.str()
+       << "    return " << r << ";\n}\n";
+    return ss.str();
+}
+
+ParserNativeFunc
+parser_jit (struct amrex_parser* parser, std::string const& expression)
+{
+#ifdef AMREX_PARSER_USE_DLOPEN
+    static std::mutex jit_mutex;
+    static std::map<std::string,ParserNativeFunc> loaded;
+
+    auto const& params = parser_jit_params();
+    if (!params.enabled) { return nullptr; }
+
+    char const* fname = "amrex_parser_native";
+    std::string src;
+    try {
+        src = parser_to_cpp(parser, fname);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string(e.what()) + " in Parser expression \""
+                                 + expression + "\"");
+    }
+
+    char key[17];
+    std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(
+                      parser_hash(src + "\n" + params.cxx + "\n" + params.flags)));
+    std::string const base = params.cache + "/amrex_parser_" + key;
+    std::string const lib = base + ".so";
+
+    std::lock_guard<std::mutex> lock(jit_mutex);
+
+    auto found = loaded.find(key);
+    if (found != loaded.end()) { return found->second; }
+
+    std::ifstream test(lib);
+    if (!test.good()) {
+        if (!amrex::UtilCreateDirectory(params.cache, 0755, false)) {
+            amrex::Warning("amrex::Parser: cannot create "+params.cache);
+            return nullptr;
+        }
+        // Parsers need not be made on all processes at the same time, so
+        // each process that misses the cache compiles.  Processes on several
+        // nodes may share the cache, so each one builds files named after
+        // its host, rank and pid, and renames them when done.
+        std::string const tmp = base + "." + parser_process_name();
+        {
+            std::ofstream ofs(tmp+".cpp");
+            ofs << parser_cpp_comment(expression) << "\n" << src;
+        }
+        std::string const cmd = params.cxx + " " + params.flags + " -o " + tmp + ".so "
+            + tmp + ".cpp > " + tmp + ".log 2>&1";
+        if (params.verbose) {
+            amrex::AllPrint() << "amrex::Parser: " << cmd << "\n";
+        }
+        if (std::system(cmd.c_str()) != 0) {
+            amrex::Warning("amrex::Parser: failed to compile \""+expression
+                           +"\", see "+tmp+".log; using the byte code instead");
+            return nullptr;
+        }
+        std::rename((tmp+".cpp").c_str(), (base+".cpp").c_str());
+        std::rename((tmp+".so").c_str(), lib.c_str());
+        std::remove((tmp+".log").c_str());
+    }
+
+    // The library is never closed, because executors may hold the function.
+    void* handle = dlopen(lib.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+        amrex::Warning(std::string("amrex::Parser: dlopen failed: ")+dlerror());
+        return nullptr;
+    }
+    auto f = reinterpret_cast<ParserNativeFunc>(dlsym(handle, fname));
+    if (f == nullptr) {
+        amrex::Warning(std::string("amrex::Parser: dlsym failed: ")+dlerror());
+        return nullptr;
+    }
+    loaded[key] = f;
+    return f;
+#else
+    amrex::ignore_unused(parser, expression);
+    return nullptr;
+#endif
+}
+
+}
@@ -1,10 +1,15 @@
 #include <AMReX.H>
 #include <AMReX_Parser_Y.H>
+#include <AMReX_Parser_Exe.H>
 #include <amrex_parser.tab.h>
 
 #include <algorithm>
 #include <cstdarg>
+#include <cstdint>
+#include <cstring>
+#include <map>
 #include <string>
+#include <vector>
 
 void
 amrex_parsererror (char const *s, ...)
@@ -123,16 +128,446 @@ parser_newlist (struct parser_node* nl, struct parser_node* nr)
 
 /*******************************************************************/
 
+/*******************************************************************/
+
+/* The functions below work on the original AST, whose nodes are allocated
+ * with std::malloc by the bison rules.  They implement common
+ * subexpression elimination (CSE): subexpressions that are evaluated more
+ * than once are computed once and stored in local variables, i.e.,
+ * executor stack slots, just like user defined local variables.
+ */
+
+static
+struct parser_node*
+parser_raw_copy (struct parser_node* node)
+{
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+        return parser_newnumber(((struct parser_number*)node)->value);
+    case PARSER_SYMBOL:
+    {
+        auto sym = parser_makesymbol(((struct parser_symbol*)node)->name);
+        sym->ip = ((struct parser_symbol*)node)->ip;
+        return parser_newsymbol(sym);
+    }
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+    case PARSER_LIST:
+        return parser_newnode(node->type, parser_raw_copy(node->l), parser_raw_copy(node->r));
+    case PARSER_NEG:
+        return parser_newnode(node->type, parser_raw_copy(node->l), nullptr);
+    case PARSER_F1:
+        return parser_newf1(((struct parser_f1*)node)->ftype,
+                            parser_raw_copy(((struct parser_f1*)node)->l));
+    case PARSER_F2:
+        return parser_newf2(((struct parser_f2*)node)->ftype,
+                            parser_raw_copy(((struct parser_f2*)node)->l),
+                            parser_raw_copy(((struct parser_f2*)node)->r));
+    case PARSER_F3:
+        return parser_newf3(((struct parser_f3*)node)->ftype,
+                            parser_raw_copy(((struct parser_f3*)node)->n1),
+                            parser_raw_copy(((struct parser_f3*)node)->n2),
+                            parser_raw_copy(((struct parser_f3*)node)->n3));
+    case PARSER_ASSIGN:
+        return parser_newassign(parser_makesymbol(((struct parser_assign*)node)->s->name),
+                                parser_raw_copy(((struct parser_assign*)node)->v));
+    default:
+        amrex::Abort("parser_raw_copy: unknown node type " + std::to_string(node->type));
+        return nullptr;
+    }
+}
+
+static
+void
+parser_raw_free (struct parser_node* node)
+{
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+        break;
+    case PARSER_SYMBOL:
+        std::free(((struct parser_symbol*)node)->name);
+        break;
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+    case PARSER_LIST:
+        parser_raw_free(node->l);
+        parser_raw_free(node->r);
+        break;
+    case PARSER_NEG:
+        parser_raw_free(node->l);
+        break;
+    case PARSER_F1:
+        parser_raw_free(((struct parser_f1*)node)->l);
+        break;
+    case PARSER_F2:
+        parser_raw_free(((struct parser_f2*)node)->l);
+        parser_raw_free(((struct parser_f2*)node)->r);
+        break;
+    case PARSER_F3:
+        parser_raw_free(((struct parser_f3*)node)->n1);
+        parser_raw_free(((struct parser_f3*)node)->n2);
+        parser_raw_free(((struct parser_f3*)node)->n3);
+        break;
+    case PARSER_ASSIGN:
+        parser_raw_free((struct parser_node*)(((struct parser_assign*)node)->s));
+        parser_raw_free(((struct parser_assign*)node)->v);
+        break;
+    default:
+        amrex::Abort("parser_raw_free: unknown node type " + std::to_string(node->type));
+    }
+    std::free((void*)node);
+}
+
+/* Can node be evaluated as part of a statement (i.e., has no ; or =)? */
+static
+bool
+parser_raw_is_expr (struct parser_node* node)
+{
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+    case PARSER_SYMBOL:
+        return true;
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+        return parser_raw_is_expr(node->l) && parser_raw_is_expr(node->r);
+    case PARSER_NEG:
+        return parser_raw_is_expr(node->l);
+    case PARSER_F1:
+        return parser_raw_is_expr(((struct parser_f1*)node)->l);
+    case PARSER_F2:
+        return parser_raw_is_expr(((struct parser_f2*)node)->l)
+            && parser_raw_is_expr(((struct parser_f2*)node)->r);
+    case PARSER_F3:
+        return parser_raw_is_expr(((struct parser_f3*)node)->n1)
+            && parser_raw_is_expr(((struct parser_f3*)node)->n2)
+            && parser_raw_is_expr(((struct parser_f3*)node)->n3);
+    default:
+        return false;
+    }
+}
+
+/* Strength reduction of pow with exponents 0.5, -0.5 and 1.5.  The results
+ * are the same as those of pow, also for -0 and -inf, where sqrt differs.
+ * Returns true if anything is changed. */
+static
+bool
+parser_raw_reduce_pow (struct parser_node*& node)
+{
+    bool changed = false;
+    switch (node->type)
+    {
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+        changed = parser_raw_reduce_pow(node->l);
+        changed = parser_raw_reduce_pow(node->r) || changed;
+        break;
+    case PARSER_NEG:
+        changed = parser_raw_reduce_pow(node->l);
+        break;
+    case PARSER_F1:
+        changed = parser_raw_reduce_pow(((struct parser_f1*)node)->l);
+        break;
+    case PARSER_F2:
+    {
+        auto f2 = (struct parser_f2*)node;
+        changed = parser_raw_reduce_pow(f2->l);
+        changed = parser_raw_reduce_pow(f2->r) || changed;
+        // x^-0.5 is parsed as x^(-(0.5)).
+        struct parser_node* e = f2->r;
+        double sign = 1.0;
+        if (e->type == PARSER_NEG) {
+            e = e->l;
+            sign = -1.0;
+        }
+        if (f2->ftype == PARSER_POW && e->type == PARSER_NUMBER) {
+            double v = sign * ((struct parser_number*)e)->value;
+            struct parser_node* r = nullptr;
+            if (v == 0.5) {
+                r = parser_newf1(PARSER_POW_HALF, f2->l);
+            } else if (v == -0.5) {
+                r = parser_newnode(PARSER_DIV, parser_newnumber(1.0),
+                                   parser_newf1(PARSER_POW_HALF, f2->l));
+            } else if (v == 1.5) {
+                // |x| keeps the sign of pow at -0 and -inf.  The two copies
+                // of the base are merged again by CSE.
+                r = parser_newnode(PARSER_MUL,
+                                   parser_newf1(PARSER_ABS, f2->l),
+                                   parser_newf1(PARSER_POW_HALF, parser_raw_copy(f2->l)));
+            }
+            if (r) {
+                if (e != f2->r) { std::free((void*)e); }
+                std::free((void*)(f2->r));
+                std::free((void*)f2);
+                node = r;
+                changed = true;
+            }
+        }
+        break;
+    }
+    case PARSER_F3:
+        changed = parser_raw_reduce_pow(((struct parser_f3*)node)->n1);
+        changed = parser_raw_reduce_pow(((struct parser_f3*)node)->n2) || changed;
+        changed = parser_raw_reduce_pow(((struct parser_f3*)node)->n3) || changed;
+        break;
+    case PARSER_ASSIGN:
+        changed = parser_raw_reduce_pow(((struct parser_assign*)node)->v);
+        break;
+    default:
+        break;
+    }
+    return changed;
+}
+
+namespace {
+
+struct ParserCSE
+{
+    struct Occurrence {
+        struct parser_node** slot;
+        int stmt;
+    };
+
+    struct Candidate {
+        std::vector<Occurrence> occ;
+        int cost = 0;
+        bool always = false; // Is at least one occurrence always evaluated?
+    };
+
+    std::vector<struct parser_node*> stmts;
+    std::map<std::string,Candidate> candidates;
+    std::map<std::string,struct parser_node*> env; // visible local variables
+    int current = 0;
+
+    // Only subexpressions at least this expensive are worth a stack slot.
+    static constexpr int min_cost = 2;
+
+    void flatten (struct parser_node* node)
+    {
+        if (node->type == PARSER_LIST) {
+            flatten(node->l);
+            flatten(node->r);
+            std::free((void*)node);
+        } else {
+            stmts.push_back(node);
+        }
+    }
+
+    // Returns a key that is the same for expressions that always have the
+    // same value, and records the non-trivial ones as candidates.
+    std::string key (struct parser_node** slot, bool always, int& cost)
+    {
+        struct parser_node* node = *slot;
+        std::string k;
+        int cl = 0, cr = 0, c3 = 0;
+        switch (node->type)
+        {
+        case PARSER_NUMBER:
+        {
+            std::uint64_t bits;
+            std::memcpy(&bits, &(((struct parser_number*)node)->value), sizeof(bits));
+            cost = 0;
+            return "#" + std::to_string(bits);
+        }
+        case PARSER_SYMBOL:
+        {
+            std::string name(((struct parser_symbol*)node)->name);
+            auto it = env.find(name);
+            cost = 0;
+            if (it != env.end()) {
+                return "$" + std::to_string(reinterpret_cast<std::uintptr_t>(it->second));
+            } else {
+                return name;
+            }
+        }
+        case PARSER_ADD:
+        case PARSER_MUL:
+        {
+            // + and * are commutative.
+            std::string kl = key(&(node->l), always, cl);
+            std::string kr = key(&(node->r), always, cr);
+            if (kr < kl) { std::swap(kl, kr); }
+            k = std::string("(") + ((node->type == PARSER_ADD) ? '+' : '*') + kl + "," + kr + ")";
+            cost = 1 + cl + cr;
+            break;
+        }
+        case PARSER_SUB:
+        case PARSER_DIV:
+            k = std::string("(") + ((node->type == PARSER_SUB) ? '-' : '/')
+                + key(&(node->l), always, cl) + "," + key(&(node->r), always, cr) + ")";
+            cost = ((node->type == PARSER_SUB) ? 1 : 4) + cl + cr;
+            break;
+        case PARSER_NEG:
+            k = "(~" + key(&(node->l), always, cl) + ")";
+            cost = 1 + cl;
+            break;
+        case PARSER_F1:
+            k = "(f" + std::to_string(((struct parser_f1*)node)->ftype)
+                + key(&(((struct parser_f1*)node)->l), always, cl) + ")";
+            cost = 10 + cl;
+            break;
+        case PARSER_F2:
+            k = "(g" + std::to_string(((struct parser_f2*)node)->ftype)
+                + key(&(((struct parser_f2*)node)->l), always, cl) + ","
+                + key(&(((struct parser_f2*)node)->r), always, cr) + ")";
+            cost = ((((struct parser_f2*)node)->ftype == PARSER_POW) ? 20 : 2) + cl + cr;
+            break;
+        case PARSER_F3:
+            // Only the condition is always evaluated.
+            k = "(?" + key(&(((struct parser_f3*)node)->n1), always, cl) + ","
+                + key(&(((struct parser_f3*)node)->n2), false, cr) + ","
+                + key(&(((struct parser_f3*)node)->n3), false, c3) + ")";
+            cost = 1 + cl + cr + c3;
+            break;
+        default:
+            amrex::Abort("ParserCSE: unknown node type " + std::to_string(node->type));
+        }
+        if (cost >= min_cost) {
+            auto& c = candidates[k];
+            c.occ.push_back(Occurrence{slot, current});
+            c.cost = cost;
+            c.always = c.always || always;
+        }
+        return k;
+    }
+
+    // Hoists the best candidate into a new local variable.
+    bool eliminate (int id)
+    {
+        candidates.clear();
+        env.clear();
+        for (current = 0; current < static_cast<int>(stmts.size()); ++current) {
+            int cost;
+            if (stmts[current]->type == PARSER_ASSIGN) {
+                auto asgn = (struct parser_assign*)stmts[current];
+                key(&(asgn->v), true, cost);
+                env[asgn->s->name] = stmts[current];
+            } else {
+                key(&(stmts[current]), true, cost);
+            }
+        }
+
+        Candidate const* best = nullptr;
+        for (auto const& kv : candidates) {
+            auto const& c = kv.second;
+            if (c.occ.size() > 1 && c.always &&
+                (best == nullptr || c.cost > best->cost ||
+                 (c.cost == best->cost && c.occ.size() > best->occ.size())))
+            {
+                best = &c;
+            }
+        }
+        if (best == nullptr) { return false; }
+
+        // The occurrences are in the order of evaluation, so the first one is
+        // in the first statement that needs the variable.
+        auto const& first = best->occ[0];
+        if (stmts[first.stmt]->type == PARSER_ASSIGN &&
+            first.slot == &(((struct parser_assign*)stmts[first.stmt])->v))
+        {
+            // It is already stored in a local variable.
+            char* name = ((struct parser_assign*)stmts[first.stmt])->s->name;
+            for (std::size_t i = 1; i < best->occ.size(); ++i) {
+                parser_raw_free(*(best->occ[i].slot));
+                *(best->occ[i].slot) = parser_newsymbol(parser_makesymbol(name));
+            }
+            return true;
+        }
+
+        // A name the lexer cannot produce cannot clash with the user's, but
+        // the AST may come from an expression that has been through CSE.
+        std::string name;
+        do {
+            name = "cse." + std::to_string(id++);
+        } while (env.count(name) > 0);
+        struct parser_node* value = *(first.slot);
+        int stmt = first.stmt;
+        for (std::size_t i = 0; i < best->occ.size(); ++i) {
+            auto slot = best->occ[i].slot;
+            if (i > 0) { parser_raw_free(*slot); }
+            *slot = parser_newsymbol(parser_makesymbol(&name[0]));
+        }
+        stmts.insert(stmts.begin() + stmt,
+                     parser_newassign(parser_makesymbol(&name[0]), value));
+        return true;
+    }
+};
+
+}
+
+/* Returns a new AST after CSE and strength reduction, or nullptr if there
+ * is nothing to do.  The given AST is not modified. */
+static
+struct parser_node*
+parser_raw_cse (struct parser_node* root, int max_variables)
+{
+    ParserCSE cse;
+    cse.flatten(parser_raw_copy(root));
+
+    // CSE is only applied to a list of assignments to distinct local
+    // variables followed by an expression.
+    bool ok = true;
+    std::set<std::string> local_symbols;
+    for (std::size_t i = 0; i < cse.stmts.size(); ++i) {
+        auto node = cse.stmts[i];
+        if (node->type == PARSER_ASSIGN) {
+            auto asgn = (struct parser_assign*)node;
+            ok = ok && parser_raw_is_expr(asgn->v)
+                && local_symbols.insert(asgn->s->name).second;
+            if (ok) {
+                std::set<std::string> symbols, unused;
+                parser_ast_get_symbols(asgn->v, symbols, unused);
+                ok = (symbols.count(asgn->s->name) == 0);
+            }
+        } else {
+            ok = ok && (i+1 == cse.stmts.size()) && parser_raw_is_expr(node);
+        }
+    }
+
+    bool changed = false;
+    if (ok) {
+        for (auto& node : cse.stmts) {
+            changed = parser_raw_reduce_pow(node) || changed;
+        }
+        for (int id = 0; id < max_variables && cse.eliminate(id); ++id) {
+            changed = true;
+        }
+    }
+
+    struct parser_node* r = cse.stmts.back();
+    for (int i = static_cast<int>(cse.stmts.size())-2; i >= 0; --i) {
+        r = parser_newlist(cse.stmts[i], r);
+    }
+
+    if (changed) {
+        return r;
+    } else {
+        parser_raw_free(r);
+        return nullptr;
+    }
+}
+
+static
 struct amrex_parser*
-amrex_parser_new ()
+parser_new_from (struct parser_node* root)
 {
     auto my_parser = (struct amrex_parser*) std::malloc(sizeof(struct amrex_parser));
 
-    my_parser->sz_mempool = parser_ast_size(parser_root);
+    my_parser->sz_mempool = parser_ast_size(root);
     my_parser->p_root = std::malloc(my_parser->sz_mempool);
     my_parser->p_free = my_parser->p_root;
 
-    my_parser->ast = parser_ast_dup(my_parser, parser_root, 1); /* 1: free the source parser_root */
+    my_parser->ast = parser_ast_dup(my_parser, root, 1); /* 1: free the source root */
 
     if ((char*)my_parser->p_root + my_parser->sz_mempool != (char*)my_parser->p_free) {
         amrex::Abort("amrex_parser_new: error in memory size");
@@ -143,6 +578,36 @@ amrex_parser_new ()
     return my_parser;
 }
 
+/* Builds a parser from an original AST, which is freed. */
+static
+struct amrex_parser*
+parser_new_with_cse (struct parser_node* root)
+{
+    // The new local variables take stack slots, so CSE is only used if the
+    // stack is still large enough.
+    struct parser_node* cse_root = parser_raw_cse(root, AMREX_PARSER_STACK_SIZE/2);
+    if (cse_root) {
+        struct amrex_parser* my_parser = parser_new_from(cse_root);
+        int max_stack_size, stack_size;
+        parser_exe_size(my_parser, max_stack_size, stack_size);
+        if (max_stack_size <= AMREX_PARSER_STACK_SIZE) {
+            parser_raw_free(root);
+            return my_parser;
+        }
+        amrex_parser_delete(my_parser);
+    }
+
+    return parser_new_from(root);
+}
+
+struct amrex_parser*
+amrex_parser_new ()
+{
+    struct parser_node* root = parser_root;
+    parser_root = nullptr;
+    return parser_new_with_cse(root);
+}
+
 void
 amrex_parser_delete (struct amrex_parser* parser)
 {
@@ -150,6 +615,372 @@ amrex_parser_delete (struct amrex_parser* parser)
     std::free(parser);
 }
 
+/*******************************************************************/
+
+/* Symbolic differentiation.  The optimized AST is converted back to an
+ * original AST, which is differentiated with the chain rule.  A nullptr
+ * stands for a derivative that is identically zero.
+ */
+
+static
+struct parser_node*
+parser_ast_to_raw (struct parser_node* node)
+{
+    auto sym = [] (struct parser_node* n) { return parser_raw_copy(n); };
+    switch (node->type)
+    {
+    case PARSER_NUMBER:
+    case PARSER_SYMBOL:
+        return parser_raw_copy(node);
+    case PARSER_ADD:
+    case PARSER_SUB:
+    case PARSER_MUL:
+    case PARSER_DIV:
+    case PARSER_LIST:
+        return parser_newnode(node->type, parser_ast_to_raw(node->l),
+                              parser_ast_to_raw(node->r));
+    case PARSER_NEG:
+        return parser_newnode(node->type, parser_ast_to_raw(node->l), nullptr);
+    case PARSER_F1:
+        return parser_newf1(((struct parser_f1*)node)->ftype,
+                            parser_ast_to_raw(((struct parser_f1*)node)->l));
+    case PARSER_F2:
+        return parser_newf2(((struct parser_f2*)node)->ftype,
+                            parser_ast_to_raw(((struct parser_f2*)node)->l),
+                            parser_ast_to_raw(((struct parser_f2*)node)->r));
+    case PARSER_F3:
+        return parser_newf3(((struct parser_f3*)node)->ftype,
+                            parser_ast_to_raw(((struct parser_f3*)node)->n1),
+                            parser_ast_to_raw(((struct parser_f3*)node)->n2),
+                            parser_ast_to_raw(((struct parser_f3*)node)->n3));
+    case PARSER_ASSIGN:
+        return parser_newassign(parser_makesymbol(((struct parser_assign*)node)->s->name),
+                                parser_ast_to_raw(((struct parser_assign*)node)->v));
+    case PARSER_ADD_VP:
+        return parser_newnode(PARSER_ADD, parser_newnumber(node->lvp.v), sym(node->r));
+    case PARSER_SUB_VP:
+        return parser_newnode(PARSER_SUB, parser_newnumber(node->lvp.v), sym(node->r));
+    case PARSER_MUL_VP:
+        return parser_newnode(PARSER_MUL, parser_newnumber(node->lvp.v), sym(node->r));
+    case PARSER_DIV_VP:
+        return parser_newnode(PARSER_DIV, parser_newnumber(node->lvp.v), sym(node->r));
+    case PARSER_ADD_PP:
+        return parser_newnode(PARSER_ADD, sym(node->l), sym(node->r));
+    case PARSER_SUB_PP:
+        return parser_newnode(PARSER_SUB, sym(node->l), sym(node->r));
+    case PARSER_MUL_PP:
+        return parser_newnode(PARSER_MUL, sym(node->l), sym(node->r));
+    case PARSER_DIV_PP:
+        return parser_newnode(PARSER_DIV, sym(node->l), sym(node->r));
+    case PARSER_NEG_P:
+        return parser_newnode(PARSER_NEG, sym(node->l), nullptr);
+    default:
+        amrex::Abort("parser_ast_to_raw: unknown node type " + std::to_string(node->type));
+        return nullptr;
+    }
+}
+
+namespace {
+
+struct ParserDiff
+{
+    std::string var;
+    std::map<std::string,bool> locals; // Does the local variable depend on var?
+
+    static std::string dname (char const* name) { return std::string("d.") + name; }
+
+    static struct parser_node* num (double v) { return parser_newnumber(v); }
+    static struct parser_node* cp (struct parser_node* n) { return parser_raw_copy(n); }
+
+    static struct parser_node* add (struct parser_node* a, struct parser_node* b)
+    {
+        if (a == nullptr) { return b; }
+        if (b == nullptr) { return a; }
+        return parser_newnode(PARSER_ADD, a, b);
+    }
+
+    static struct parser_node* sub (struct parser_node* a, struct parser_node* b)
+    {
+        if (b == nullptr) { return a; }
+        if (a == nullptr) { return parser_newnode(PARSER_NEG, b, nullptr); }
+        return parser_newnode(PARSER_SUB, a, b);
+    }
+
+    // a * db, where db may be zero.
+    static struct parser_node* mul (struct parser_node* a, struct parser_node* db)
+    {
+        if (db == nullptr) {
+            parser_raw_free(a);
+            return nullptr;
+        }
+        return parser_newnode(PARSER_MUL, a, db);
+    }
+
+    static struct parser_node* f1 (enum parser_f1_t t, struct parser_node* a)
+    {
+        return parser_newf1(t, a);
+    }
+
+    static struct parser_node* f2 (enum parser_f2_t t, struct parser_node* a,
+                                   struct parser_node* b)
+    {
+        return parser_newf2(t, a, b);
+    }
+
+    static struct parser_node* bin (enum parser_node_t t, struct parser_node* a,
+                                    struct parser_node* b)
+    {
+        return parser_newnode(t, a, b);
+    }
+
+    struct parser_node* d (struct parser_node* node)
+    {
+        switch (node->type)
+        {
+        case PARSER_NUMBER:
+            return nullptr;
+        case PARSER_SYMBOL:
+        {
+            char const* name = ((struct parser_symbol*)node)->name;
+            auto it = locals.find(name);
+            if (it != locals.end()) {
+                if (!it->second) { return nullptr; }
+                std::string dn = dname(name);
+                return parser_newsymbol(parser_makesymbol(&dn[0]));
+            } else if (var == name) {
+                return num(1.0);
+            } else {
+                return nullptr;
+            }
+        }
+        case PARSER_ADD:
+            return add(d(node->l), d(node->r));
+        case PARSER_SUB:
+            return sub(d(node->l), d(node->r));
+        case PARSER_MUL:
+            return add(mul(cp(node->r), d(node->l)), mul(cp(node->l), d(node->r)));
+        case PARSER_DIV:
+            // (l/r)' = l'/r - (l/r) * r'/r
+            return sub(mul(bin(PARSER_DIV, num(1.0), cp(node->r)), d(node->l)),
+                       mul(bin(PARSER_DIV, cp(node), cp(node->r)), d(node->r)));
+        case PARSER_NEG:
+        {
+            auto dl = d(node->l);
+            return dl ? parser_newnode(PARSER_NEG, dl, nullptr) : nullptr;
+        }
+        case PARSER_F1:
+            return df1(((struct parser_f1*)node)->ftype, ((struct parser_f1*)node)->l);
+        case PARSER_F2:
+            return df2(((struct parser_f2*)node)->ftype, node,
+                       ((struct parser_f2*)node)->l, ((struct parser_f2*)node)->r);
+        case PARSER_F3:
+        {
+            auto f3 = (struct parser_f3*)node;
+            auto dt = d(f3->n2);
+            auto df = d(f3->n3);
+            if (dt == nullptr && df == nullptr) { return nullptr; }
+            return parser_newf3(f3->ftype, cp(f3->n1), dt ? dt : num(0.0), df ? df : num(0.0));
+        }
+        default:
+            amrex::Abort("Parser::derivative: unsupported node type "
+                         + std::to_string(node->type));
+            return nullptr;
+        }
+    }
+
+    struct parser_node* df1 (enum parser_f1_t t, struct parser_node* u)
+    {
+        auto du = d(u);
+        if (du == nullptr) { return nullptr; }
+        struct parser_node* f = nullptr;
+        switch (t)
+        {
+        case PARSER_SQRT:
+            f = bin(PARSER_DIV, num(0.5), f1(PARSER_SQRT, cp(u)));
+            break;
+        case PARSER_EXP:
+            f = f1(PARSER_EXP, cp(u));
+            break;
+        case PARSER_LOG:
+            f = f1(PARSER_POW_M1, cp(u));
+            break;
+        case PARSER_LOG10:
+            f = bin(PARSER_DIV, num(1.0/std::log(10.0)), cp(u));
+            break;
+        case PARSER_SIN:
+            f = f1(PARSER_COS, cp(u));
+            break;
+        case PARSER_COS:
+            f = parser_newnode(PARSER_NEG, f1(PARSER_SIN, cp(u)), nullptr);
+            break;
+        case PARSER_TAN:
+            f = f1(PARSER_POW_M2, f1(PARSER_COS, cp(u)));
+            break;
+        case PARSER_ASIN:
+            f = bin(PARSER_DIV, num(1.0),
+                    f1(PARSER_SQRT, bin(PARSER_SUB, num(1.0), f1(PARSER_POW_P2, cp(u)))));
+            break;
+        case PARSER_ACOS:
+            f = bin(PARSER_DIV, num(-1.0),
+                    f1(PARSER_SQRT, bin(PARSER_SUB, num(1.0), f1(PARSER_POW_P2, cp(u)))));
+            break;
+        case PARSER_ATAN:
+            f = f1(PARSER_POW_M1, bin(PARSER_ADD, num(1.0), f1(PARSER_POW_P2, cp(u))));
+            break;
+        case PARSER_SINH:
+            f = f1(PARSER_COSH, cp(u));
+            break;
+        case PARSER_COSH:
+            f = f1(PARSER_SINH, cp(u));
+            break;
+        case PARSER_TANH:
+            f = f1(PARSER_POW_M2, f1(PARSER_COSH, cp(u)));
+            break;
+        case PARSER_ABS:
+            f = bin(PARSER_SUB, f2(PARSER_GT, cp(u), num(0.0)), f2(PARSER_LT, cp(u), num(0.0)));
+            break;
+        case PARSER_FLOOR:
+        case PARSER_CEIL:
+            parser_raw_free(du);
+            return nullptr;
+        case PARSER_POW_M3:
+            f = bin(PARSER_MUL, num(-3.0), f1(PARSER_POW_P2, f1(PARSER_POW_M2, cp(u))));
+            break;
+        case PARSER_POW_M2:
+            f = bin(PARSER_MUL, num(-2.0), f1(PARSER_POW_M3, cp(u)));
+            break;
+        case PARSER_POW_M1:
+            f = parser_newnode(PARSER_NEG, f1(PARSER_POW_M2, cp(u)), nullptr);
+            break;
+        case PARSER_POW_P1:
+            return du;
+        case PARSER_POW_P2:
+            f = bin(PARSER_MUL, num(2.0), cp(u));
+            break;
+        case PARSER_POW_P3:
+            f = bin(PARSER_MUL, num(3.0), f1(PARSER_POW_P2, cp(u)));
+            break;
+        case PARSER_POW_HALF:
+            f = bin(PARSER_DIV, num(0.5), f1(PARSER_POW_HALF, cp(u)));
+            break;
+        default:
+            amrex::Abort("Parser::derivative: unknown function");
+        }
+        return mul(f, du);
+    }
+
+    struct parser_node* df2 (enum parser_f2_t t, struct parser_node* node,
+                             struct parser_node* a, struct parser_node* b)
+    {
+        switch (t)
+        {
+        case PARSER_POW:
+        {
+            auto da = d(a);
+            auto db = d(b);
+            // (a^b)' = b*a^(b-1)*a' + a^b*log(a)*b'
+            auto r = mul(bin(PARSER_MUL, cp(b), f2(PARSER_POW, cp(a),
+                                                   bin(PARSER_SUB, cp(b), num(1.0)))), da);
+            return add(r, mul(bin(PARSER_MUL, cp(node), f1(PARSER_LOG, cp(a))), db));
+        }
+        case PARSER_GT:
+        case PARSER_LT:
+        case PARSER_GEQ:
+        case PARSER_LEQ:
+        case PARSER_EQ:
+        case PARSER_NEQ:
+        case PARSER_AND:
+        case PARSER_OR:
+        case PARSER_HEAVISIDE:
+            return nullptr; // piecewise constant
+        case PARSER_JN:
+        {
+            // jn(n,x)' = (jn(n-1,x) - jn(n+1,x))/2 * x'
+            auto db = d(b);
+            if (db == nullptr) { return nullptr; }
+            auto f = bin(PARSER_MUL, num(0.5),
+                         bin(PARSER_SUB,
+                             f2(PARSER_JN, bin(PARSER_SUB, cp(a), num(1.0)), cp(b)),
+                             f2(PARSER_JN, bin(PARSER_ADD, cp(a), num(1.0)), cp(b))));
+            return mul(f, db);
+        }
+        case PARSER_MIN:
+        case PARSER_MAX:
+        {
+            auto da = d(a);
+            auto db = d(b);
+            if (da == nullptr && db == nullptr) { return nullptr; }
+            auto c = f2((t == PARSER_MIN) ? PARSER_LT : PARSER_GT, cp(a), cp(b));
+            return parser_newf3(PARSER_IF, c, da ? da : num(0.0), db ? db : num(0.0));
+        }
+        case PARSER_FMOD:
+        {
+            // fmod(a,b) = a - b*trunc(a/b), and trunc(a/b) = (a-fmod(a,b))/b
+            auto da = d(a);
+            auto db = d(b);
+            return sub(da, mul(bin(PARSER_DIV, bin(PARSER_SUB, cp(a), cp(node)), cp(b)), db));
+        }
+        default:
+            amrex::Abort("Parser::derivative: unknown function");
+            return nullptr;
+        }
+    }
+};
+
+}
+
+struct amrex_parser*
+parser_derivative (struct amrex_parser* parser, char const* var)
+{
+    std::vector<struct parser_node*> stmts;
+    std::vector<struct parser_node*> work{parser_ast_to_raw(parser->ast)};
+    while (!work.empty()) {
+        auto node = work.back();
+        work.pop_back();
+        if (node->type == PARSER_LIST) {
+            work.push_back(node->r);
+            work.push_back(node->l);
+            std::free((void*)node);
+        } else {
+            stmts.push_back(node);
+        }
+    }
+
+    // Each local variable a = e is followed by its derivative d.a = e'.
+    ParserDiff diff;
+    diff.var = var;
+    std::vector<struct parser_node*> out;
+    for (std::size_t i = 0; i < stmts.size(); ++i) {
+        auto node = stmts[i];
+        if (node->type == PARSER_ASSIGN) {
+            auto asgn = (struct parser_assign*)node;
+            auto dv = diff.d(asgn->v);
+            out.push_back(node);
+            diff.locals[asgn->s->name] = (dv != nullptr);
+            std::string dn = ParserDiff::dname(asgn->s->name);
+            if (dv) {
+                out.push_back(parser_newassign(parser_makesymbol(&dn[0]), dv));
+            }
+            if (i+1 == stmts.size()) { // The value of the expression is a.
+                out.push_back(dv ? parser_newsymbol(parser_makesymbol(&dn[0]))
+                                 : parser_newnumber(0.0));
+            }
+        } else if (i+1 == stmts.size()) {
+            auto dv = diff.d(node);
+            out.push_back(dv ? dv : parser_newnumber(0.0));
+            parser_raw_free(node);
+        } else {
+            amrex::Abort("Parser::derivative: unsupported expression");
+        }
+    }
+
+    struct parser_node* r = out.back();
+    for (int i = static_cast<int>(out.size())-2; i >= 0; --i) {
+        r = parser_newlist(out[i], r);
+    }
+    return parser_new_with_cse(r);
+}
+
 static
 std::size_t
 parser_aligned_size (std::size_t N)
@@ -1101,6 +1932,10 @@ parser_ast_optimize (struct parser_node* node)
                 ((struct parser_f1*)node)->type = PARSER_F1;
                 ((struct parser_f1*)node)->l = n;
                 ((struct parser_f1*)node)->ftype = PARSER_POW_P3;
+            } else if (0.5 == v) {
+                ((struct parser_f1*)node)->type = PARSER_F1;
+                ((struct parser_f1*)node)->l = n;
+                ((struct parser_f1*)node)->ftype = PARSER_POW_HALF;
             }
         }
         break;
@@ -1206,6 +2041,7 @@ parser_ast_print_f1 (struct parser_f1* f1, std::string const& space, AllPrint& p
     case PARSER_POW_P1:      printer << "POW(,1)\n";     break;
     case PARSER_POW_P2:      printer << "POW(,2)\n";     break;
     case PARSER_POW_P3:      printer << "POW(,3)\n";     break;
+    case PARSER_POW_HALF:    printer << "POW(,0.5)\n";   break;
     default:
         amrex::AllPrint() << "parser_ast_print_f1: Unknown function " << f1->ftype << "\n";
     }
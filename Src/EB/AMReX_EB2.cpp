@@ -11,9 +11,13 @@
 #include <AMReX_EB2_GeometryShop.H>
 #include <AMReX_EB2.H>
 #include <AMReX_EB2_IndexSpace_STL.H>
+#include <AMReX_EB2_IndexSpace_Cache.H>
 #include <AMReX_ParmParse.H>
+#include <AMReX_StartupCache.H>
 #include <AMReX.H>
 #include <algorithm>
+#include <iomanip>
+#include <sstream>
 
 namespace amrex { namespace EB2 {
 
@@ -88,6 +92,42 @@ Build (const Geometry& geom, int required_coarsening_level,
     std::string geom_type;
     pp.get("geom_type", geom_type);
 
+    //
+    // The geometry is fully described by the eb2 parameters and the
+    // arguments, so the index space can be taken from the startup cache.
+    //
+    std::string cache_key;
+    if (StartupCache::enabled() && geom_type != "all_regular")
+    {
+        std::ostringstream os;
+        os << std::setprecision(17)
+           << "spacedim = " << AMREX_SPACEDIM << "\n"
+           << "sizeof(Real) = " << sizeof(Real) << "\n"
+           << "domain = " << geom.Domain() << "\n"
+           << "prob_domain = " << geom.ProbDomain() << "\n"
+           << "coord = " << geom.Coord() << "\n"
+           << "is_periodic =" AMREX_D_TERM(<< " " << geom.isPeriodic(0),
+                                           << " " << geom.isPeriodic(1),
+                                           << " " << geom.isPeriodic(2)) << "\n"
+           << "required_coarsening_level = " << required_coarsening_level << "\n"
+           << "max_coarsening_level = " << max_coarsening_level << "\n"
+           << "ngrow = " << ngrow << "\n"
+           << "build_coarse_level_by_coarsening = " << build_coarse_level_by_coarsening << "\n"
+           << "extend_domain_face = " << a_extend_domain_face << "\n"
+           << "num_coarsen_opt = " << a_num_coarsen_opt << "\n"
+           << "max_grid_size = " << EB2::max_grid_size << "\n";
+        if (geom_type == "stl") {
+            std::string stl_file;
+            pp.get("stl_file", stl_file);
+            os << "stl_file_hash = " << StartupCache::hashFile(stl_file) << "\n";
+        }
+        cache_key = StartupCache::makeKey("eb2", {"eb2."}, os.str());
+        if (StartupCache::exists(cache_key)) {
+            IndexSpace::push(new IndexSpaceCache(StartupCache::entryPath(cache_key), geom));
+            return;
+        }
+    }
+
     if (geom_type == "all_regular")
     {
         EB2::AllRegularIF rif;
@@ -228,6 +268,12 @@ Build (const Geometry& geom, int required_coarsening_level,
     {
         amrex::Abort("geom_type "+geom_type+ " not supported");
     }
+
+    if (!cache_key.empty()) {
+        std::string dir = StartupCache::beginWrite(cache_key);
+        IndexSpaceCache::write(IndexSpace::top(), geom, dir);
+        StartupCache::commit(cache_key, dir);
+    }
 }
 
 void addFineLevels (int num_new_fine_levels)
@@ -0,0 +1,73 @@
+#include <AMReX_EB2_IndexSpace_Cache.H>
+
+#include <fstream>
+#include <sstream>
+
+namespace amrex { namespace EB2 {
+
+IndexSpaceCache::IndexSpaceCache (const std::string& dirname, const Geometry& geom)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(dirname+"/EB2Header", buf);
+    std::istringstream is(buf.dataPtr());
+    int nlevels = 0;
+    is >> nlevels;
+    if (is.fail() || nlevels < 1) {
+        amrex::Abort("EB2::IndexSpaceCache: failed to read "+dirname+"/EB2Header");
+    }
+
+    m_cachelevel.reserve(nlevels);
+    for (int ilev = 0; ilev < nlevels; ++ilev)
+    {
+        Geometry g = (ilev == 0) ? geom : amrex::coarsen(m_geom.back(),2);
+        m_cachelevel.emplace_back(this, g, dirname+"/Level_"+std::to_string(ilev));
+        m_geom.push_back(g);
+        m_domain.push_back(g.Domain());
+    }
+}
+
+const Level&
+IndexSpaceCache::getLevel (const Geometry& geom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), geom.Domain());
+    int i = std::distance(m_domain.begin(), it);
+    return m_cachelevel[i];
+}
+
+const Geometry&
+IndexSpaceCache::getGeometry (const Box& dom) const
+{
+    auto it = std::find(std::begin(m_domain), std::end(m_domain), dom);
+    int i = std::distance(m_domain.begin(), it);
+    return m_geom[i];
+}
+
+void
+IndexSpaceCache::addFineLevels (int /*num_new_fine_levels*/)
+{
+    amrex::Abort("IndexSpaceCache::addFineLevels: not supported");
+}
+
+void
+IndexSpaceCache::write (const IndexSpace& ebis, const Geometry& geom,
+                        const std::string& dirname)
+{
+    Geometry g = geom;
+    int nlevels = 0;
+    for (;;) {
+        CacheLevel::write(ebis.getLevel(g), dirname+"/Level_"+std::to_string(nlevels));
+        ++nlevels;
+        if (g.Domain() == ebis.coarsestDomain()) { break; }
+        g = amrex::coarsen(g,2);
+    }
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream ofs(dirname+"/EB2Header");
+        ofs << nlevels << '\n';
+        if (!ofs.good()) {
+            amrex::Abort("EB2::IndexSpaceCache: failed to write "+dirname+"/EB2Header");
+        }
+    }
+}
+
+}}
@@ -0,0 +1,171 @@
+#include <AMReX_EB2_Level_Cache.H>
+#include <AMReX_Utility.H>
+
+#include <sstream>
+
+namespace amrex { namespace EB2 {
+
+namespace {
+    //
+    // EBCellFlag is stored as two 16-bit halves so that it is exact even
+    // with single precision Real.
+    //
+    void cellFlagToMultiFab (MultiFab& mf, FabArray<EBCellFlagFab> const& cellflag)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.fabbox();
+            auto const& cflag = cellflag.const_array(mfi);
+            auto const& a = mf.array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+            {
+                const uint32_t v = cflag(i,j,k).getValue();
+                a(i,j,k,0) = static_cast<Real>(v & 0xffffu);
+                a(i,j,k,1) = static_cast<Real>(v >> 16);
+            });
+        }
+    }
+
+    void multiFabToCellFlag (FabArray<EBCellFlagFab>& cellflag, MultiFab const& mf)
+    {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.fabbox();
+            auto const& cflag = cellflag.array(mfi);
+            auto const& a = mf.const_array(mfi);
+            AMREX_HOST_DEVICE_PARALLEL_FOR_3D(bx, i, j, k,
+            {
+                const auto lo = static_cast<uint32_t>(a(i,j,k,0));
+                const auto hi = static_cast<uint32_t>(a(i,j,k,1));
+                cflag(i,j,k) = EBCellFlag(lo | (hi << 16));
+            });
+        }
+    }
+}
+
+CacheLevel::CacheLevel (IndexSpace const* is, const Geometry& geom, const std::string& dirname)
+    : Level(is, geom)
+{
+    BL_PROFILE("EB2::CacheLevel()");
+
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(dirname+"/Header", buf);
+    std::istringstream hs(buf.dataPtr());
+
+    int has_grids = 0, has_covered_grids = 0, has_levelset = 0;
+    hs >> m_ngrow >> m_allregular >> m_ok >> has_grids >> has_covered_grids >> has_levelset;
+    if (has_grids) {
+        m_grids.readFrom(hs);
+    }
+    if (has_covered_grids) {
+        m_covered_grids.readFrom(hs);
+    }
+    if (hs.fail()) {
+        amrex::Abort("EB2::CacheLevel: failed to read "+dirname+"/Header");
+    }
+
+    if (m_grids.empty()) { return; }
+
+    m_dmap = DistributionMapping(m_grids);
+
+    const int ng = GFab::ng;
+    MFInfo mf_info;
+    mf_info.SetTag("EB2::Level");
+    m_cellflag.define(m_grids, m_dmap, 1, ng, mf_info);
+    m_volfrac.define(m_grids, m_dmap, 1, ng, mf_info);
+    m_centroid.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    m_bndryarea.define(m_grids, m_dmap, 1, ng, mf_info);
+    m_bndrycent.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    m_bndrynorm.define(m_grids, m_dmap, AMREX_SPACEDIM, ng, mf_info);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        m_areafrac[idim].define(amrex::convert(m_grids, IntVect::TheDimensionVector(idim)),
+                                m_dmap, 1, ng, mf_info);
+        m_facecent[idim].define(amrex::convert(m_grids, IntVect::TheDimensionVector(idim)),
+                                m_dmap, AMREX_SPACEDIM-1, ng, mf_info);
+        IntVect edge_type{1}; edge_type[idim] = 0;
+        m_edgecent[idim].define(amrex::convert(m_grids, edge_type), m_dmap, 1, ng, mf_info);
+    }
+
+    {
+        MultiFab tmp(m_grids, m_dmap, 2, ng);
+        VisMF::Read(tmp, dirname+"/cellflag");
+        multiFabToCellFlag(m_cellflag, tmp);
+    }
+    VisMF::Read(m_volfrac, dirname+"/volfrac");
+    VisMF::Read(m_centroid, dirname+"/centroid");
+    VisMF::Read(m_bndryarea, dirname+"/bndryarea");
+    VisMF::Read(m_bndrycent, dirname+"/bndrycent");
+    VisMF::Read(m_bndrynorm, dirname+"/bndrynorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        VisMF::Read(m_areafrac[idim], dirname+"/areafrac_"+std::to_string(idim));
+        VisMF::Read(m_facecent[idim], dirname+"/facecent_"+std::to_string(idim));
+        VisMF::Read(m_edgecent[idim], dirname+"/edgecent_"+std::to_string(idim));
+    }
+    if (has_levelset) {
+        m_levelset.define(amrex::convert(m_grids,IntVect::TheNodeVector()), m_dmap, 1, 0);
+        VisMF::Read(m_levelset, dirname+"/levelset");
+    }
+}
+
+void
+CacheLevel::write (const Level& level, const std::string& dirname)
+{
+    BL_PROFILE("EB2::CacheLevel::write()");
+
+    if (ParallelDescriptor::IOProcessor()) {
+        if (!amrex::UtilCreateDirectory(dirname, 0755)) {
+            amrex::CreateDirectoryFailed(dirname);
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    const bool has_grids = !level.m_grids.empty();
+    const bool has_levelset = has_grids && level.m_levelset.ok();
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream ofs(dirname+"/Header");
+        ofs << level.m_ngrow << ' ' << level.m_allregular << ' ' << level.m_ok << ' '
+            << has_grids << ' ' << !level.m_covered_grids.empty() << ' '
+            << has_levelset << '\n';
+        if (has_grids) {
+            level.m_grids.writeOn(ofs);
+            ofs << '\n';
+        }
+        if (!level.m_covered_grids.empty()) {
+            level.m_covered_grids.writeOn(ofs);
+            ofs << '\n';
+        }
+        if (!ofs.good()) {
+            amrex::Abort("EB2::CacheLevel: failed to write "+dirname+"/Header");
+        }
+    }
+
+    if (!has_grids) { return; }
+
+    {
+        MultiFab tmp(level.m_grids, level.m_dmap, 2, level.m_cellflag.nGrow());
+        cellFlagToMultiFab(tmp, level.m_cellflag);
+        VisMF::Write(tmp, dirname+"/cellflag");
+    }
+    VisMF::Write(level.m_volfrac, dirname+"/volfrac");
+    VisMF::Write(level.m_centroid, dirname+"/centroid");
+    VisMF::Write(level.m_bndryarea, dirname+"/bndryarea");
+    VisMF::Write(level.m_bndrycent, dirname+"/bndrycent");
+    VisMF::Write(level.m_bndrynorm, dirname+"/bndrynorm");
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        VisMF::Write(level.m_areafrac[idim], dirname+"/areafrac_"+std::to_string(idim));
+        VisMF::Write(level.m_facecent[idim], dirname+"/facecent_"+std::to_string(idim));
+        VisMF::Write(level.m_edgecent[idim], dirname+"/edgecent_"+std::to_string(idim));
+    }
+    if (has_levelset) {
+        VisMF::Write(level.m_levelset, dirname+"/levelset");
+    }
+}
+
+}}
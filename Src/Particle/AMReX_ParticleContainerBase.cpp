@@ -165,6 +165,18 @@ const std::string& ParticleContainerBase::PlotfileVersion ()
     return plotfile_version;
 }
 
+const std::string& ParticleContainerBase::AggregatedVersion ()
+{
+    //
+    // Column-wise, optionally compressed blocks written by
+    // WriteBinaryParticleDataAggregated.  Particle ids are always stored
+    // in the expanded checkpoint form.
+    //
+    static const std::string aggregated_version("Version_Three_Dot_Zero_Aggregated");
+
+    return aggregated_version;
+}
+
 const std::string& ParticleContainerBase::DataPrefix ()
 {
     //
@@ -368,7 +368,7 @@ AmrCoreAdv::AdvancePhiAtLevel (int lev, Real time, Real dt_lev, int /*iteration*
         if (flux_reg[lev+1]) {
             for (int i = 0; i < AMREX_SPACEDIM; ++i) {
                 // update the lev+1/lev flux register (index lev+1)
-                flux_reg[lev+1]->CrseInit(fluxes[i],i,0,0,fluxes[i].nComp(), -1.0);
+                flux_reg[lev+1]->CrseInit_nowait(fluxes[i],i,0,0,fluxes[i].nComp(), -1.0);
             }
         }
         if (flux_reg[lev]) {
@@ -377,5 +377,9 @@ AmrCoreAdv::AdvancePhiAtLevel (int lev, Real time, Real dt_lev, int /*iteration*
                 flux_reg[lev]->FineAdd(fluxes[i],i,0,0,fluxes[i].nComp(), 1.0);
             }
         }
+        if (flux_reg[lev+1]) {
+            // the FineAdd above overlaps with the communication of CrseInit
+            flux_reg[lev+1]->CrseInit_finish();
+        }
     }
 }
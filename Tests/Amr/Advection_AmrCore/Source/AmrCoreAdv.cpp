@@ -227,13 +227,11 @@ AmrCoreAdv::RemakeLevel (int lev, Real time, const BoxArray& ba,
     const int ncomp = phi_new[lev].nComp();
     const int ng = phi_new[lev].nGrow();
 
-    MultiFab new_state(ba, dm, ncomp, ng);
-    MultiFab old_state(ba, dm, ncomp, ng);
-
-    FillPatch(lev, time, new_state, 0, ncomp);
-
-    std::swap(new_state, phi_new[lev]);
-    std::swap(old_state, phi_old[lev]);
+    // FABs of boxes that did not move keep their data; only the other
+    // boxes are filled.
+    amrex::RegridFabArray(phi_new[lev], ba, dm,
+                          [&] (MultiFab& mf) { FillPatch(lev, time, mf, 0, ncomp); });
+    phi_old[lev] = MultiFab(ba, dm, ncomp, ng);
 
     t_new[lev] = time;
     t_old[lev] = time - 1.e200;
@@ -357,6 +355,19 @@ AmrCoreAdv::ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/)
     }
 }
 
+// sweep tags along the velocity over the time until the next regrid
+// overrides the virtual function in AmrCore
+Array<MultiFab const*,AMREX_SPACEDIM>
+AmrCoreAdv::TagSweepVelocity (int lev, Real /*time*/, Real& sweep_time)
+{
+    // there is no velocity before the first step
+    if (sweep_tags && istep[lev] > 0) {
+        sweep_time = regrid_int * dt[lev];
+        return GetArrOfConstPtrs(facevel[lev]);
+    }
+    return {{AMREX_D_DECL(nullptr,nullptr,nullptr)}};
+}
+
 // read in some parameters from inputs file
 void
 AmrCoreAdv::ReadParameters ()
@@ -384,6 +395,7 @@ AmrCoreAdv::ReadParameters ()
         pp.query("cfl", cfl);
         pp.query("do_reflux", do_reflux);
         pp.query("do_subcycle", do_subcycle);
+        pp.query("sweep_tags", sweep_tags);
     }
 
 #ifdef AMREX_PARTICLES
@@ -618,10 +630,16 @@ AmrCoreAdv::timeStepWithSubcycling (int lev, Real time, int iteration)
 
     if (lev < finest_level)
     {
-        // recursive call for next-finer level
-        for (int i = 1; i <= nsubsteps[lev+1]; ++i)
         {
-            timeStepWithSubcycling(lev+1, time+(i-1)*dt[lev+1], i);
+            // phi at lev does not change during the substeps of lev+1, so
+            // the coarse data copied by FillPatch can be reused
+            CrsePatchCache crse_patch_cache({&phi_old[lev], &phi_new[lev]});
+
+            // recursive call for next-finer level
+            for (int i = 1; i <= nsubsteps[lev+1]; ++i)
+            {
+                timeStepWithSubcycling(lev+1, time+(i-1)*dt[lev+1], i);
+            }
         }
 
         if (do_reflux)
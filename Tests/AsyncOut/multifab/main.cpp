@@ -1,6 +1,7 @@
 #include <AMReX.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_VisMF.H>
+#include <AMReX_PlotFileUtil.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_BLProfiler.H>
 
@@ -206,4 +207,34 @@ void main_main ()
         }
     }
     ParallelDescriptor::Barrier();
+
+// ***************************************************************
+
+    amrex::Print() << " AsyncOut multi-level plotfile " << std::endl;
+    {
+        BL_PROFILE_REGION("plotfile-async");
+        Vector<const MultiFab*> mfptrs;
+        Vector<Geometry> geoms;
+        Vector<int> steps;
+        Vector<IntVect> ref_ratio;
+        Geometry geom(ba.minimalBox(), RealBox(AMREX_D_DECL(0.,0.,0.),AMREX_D_DECL(1.,1.,1.)),
+                      CoordSys::cartesian, Array<int,AMREX_SPACEDIM>{AMREX_D_DECL(0,0,0)});
+        for (int m = 0; m < nwrites; ++m) {
+            mfptrs.push_back(&mfs[m]);
+            geoms.push_back(geom);
+            steps.push_back(0);
+            ref_ratio.push_back(IntVect(1));
+        }
+        auto handle = WriteMultiLevelPlotfileAsync("vismfdata/plt-async", nwrites, mfptrs,
+                                                   {"random"}, geoms, 0.0, steps, ref_ratio);
+        {
+            BL_PROFILE_VAR("plotfile-async-wait", blp4);
+            handle.wait();
+        }
+        if (AsyncOut::StagingBytesInUse() != 0) {
+            amrex::AllPrint() << "Staging memory not released: "
+                              << AsyncOut::StagingBytesInUse() << std::endl;
+        }
+    }
+    ParallelDescriptor::Barrier();
 }
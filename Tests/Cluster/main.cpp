@@ -0,0 +1,164 @@
+#include <AMReX.H>
+#include <AMReX_Cluster.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace {
+
+// A few blobs and scattered cells, so that the cluster tree has several
+// levels and both kinds of cuts.
+bool is_tagged (IntVect const& iv)
+{
+    const IntVect c1(AMREX_D_DECL(12,20,16));
+    const IntVect c2(AMREX_D_DECL(44,40,48));
+    int r1 = 0, r2 = 0;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        r1 += (iv[d]-c1[d])*(iv[d]-c1[d]);
+        r2 += (iv[d]-c2[d])*(iv[d]-c2[d]);
+    }
+    unsigned h = 2166136261U;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        h = (h ^ static_cast<unsigned>(iv[d])) * 16777619U;
+    }
+    return r1 <= 49 || (r2 <= 100 && r2 >= 36) || (h % 997U == 0);
+}
+
+Vector<Box> sorted_boxes (BoxList const& bl)
+{
+    Vector<Box> v(bl.begin(), bl.end());
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// Compares ClusterList::distributedChop with the serial ClusterList on the
+// I/O process.
+int test (TagBoxArray const& tags, BoxArray const& domba, Real eff, bool use_new_chop)
+{
+    amrex::Print() << "Testing eff = " << eff << ", new_chop = " << use_new_chop << "   ";
+
+    Gpu::PinnedVector<IntVect> tagvec;
+    tags.collate(tagvec);
+    BoxList serial_bl;
+    if (ParallelDescriptor::IOProcessor()) {
+        BoxArray ba = domba;
+        ClusterList clist(tagvec.data(), tagvec.size());
+        if (use_new_chop) {
+            clist.new_chop(eff);
+        } else {
+            clist.chop(eff);
+        }
+        clist.intersect(ba);
+        clist.boxList(serial_bl);
+    }
+    serial_bl.Bcast();
+
+    Gpu::PinnedVector<IntVect> local_tagvec;
+    tags.local_collate(local_tagvec);
+    BoxArray ba = domba;
+    BoxList dist_bl = ClusterList::distributedChop(local_tagvec.data(), local_tagvec.size(),
+                                                   eff, ba, use_new_chop);
+
+    const auto serial = sorted_boxes(serial_bl);
+    const auto dist = sorted_boxes(dist_bl);
+    // The result must be the same on every process.
+    Long n = dist.size();
+    ParallelDescriptor::ReduceLongMax(n);
+    if (serial.size() > 1 && serial == dist && Long(dist.size()) == n) {
+        amrex::Print() << serial.size() << " boxes   pass\n";
+        return 0;
+    } else {
+        amrex::Print() << serial.size() << " vs. " << dist.size() << " boxes   failed\n";
+        return 1;
+    }
+}
+
+// The runs of tags gathered by collate must give the cells of the tags,
+// as local_collate_cpu does on each process.
+int test_collate (TagBoxArray const& tags)
+{
+    amrex::Print() << "Testing collate   ";
+
+    Gpu::PinnedVector<IntVect> tagvec;
+    tags.collate(tagvec);
+    Vector<IntVect> global(tagvec.begin(), tagvec.end());
+    std::sort(global.begin(), global.end());
+
+    Vector<IntVect> expected;
+    const Box domain = tags.boxArray().minimalBox();
+    for (IntVect iv = domain.smallEnd(); domain.contains(iv); domain.next(iv)) {
+        if (is_tagged(iv)) { expected.push_back(iv); }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    int nerror = 0;
+    if (ParallelDescriptor::IOProcessor() && global != expected) { ++nerror; }
+
+    Gpu::PinnedVector<IntVect> local_tagvec;
+    tags.local_collate_cpu(local_tagvec);
+    Vector<IntVect> local(local_tagvec.begin(), local_tagvec.end());
+    std::sort(local.begin(), local.end());
+    Vector<IntVect> local_expected;
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+        const Box& vbx = mfi.validbox();
+        for (IntVect iv = vbx.smallEnd(); vbx.contains(iv); vbx.next(iv)) {
+            if (is_tagged(iv)) { local_expected.push_back(iv); }
+        }
+    }
+    std::sort(local_expected.begin(), local_expected.end());
+    if (local != local_expected) { ++nerror; }
+
+    ParallelDescriptor::ReduceIntMax(nerror);
+    if (nerror == 0) {
+        amrex::Print() << expected.size() << " tags   pass\n";
+        return 0;
+    } else {
+        amrex::Print() << "failed\n";
+        return 1;
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        const Box domain(IntVect(0), IntVect(63));
+        BoxArray ba(domain);
+        ba.maxSize(16);
+        DistributionMapping dm(ba);
+        TagBoxArray tags(ba, dm);
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+            auto const& a = tags.array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                a(i,j,k) = is_tagged(IntVect(AMREX_D_DECL(i,j,k))) ? TagBox::SET : TagBox::CLEAR;
+            });
+        }
+
+        // The proper nesting domain misses a corner of the domain.
+        const BoxArray domba(amrex::complementIn(domain,
+                                                 BoxList(Box(IntVect(40), IntVect(63)))));
+
+        int nerror = test_collate(tags);
+        for (Real eff : {Real(0.7), Real(0.9)}) {
+            for (bool use_new_chop : {false, true}) {
+                nerror += test(tags, domba, eff, use_new_chop);
+            }
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerror);
+        if (nerror > 0) {
+            amrex::Print() << nerror << " tests failed\n";
+            amrex::Abort();
+        } else {
+            amrex::Print() << "All tests passed\n";
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,376 @@
+#include <AMReX.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <functional>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+void fill (MultiFab& mf, Geometry const& geom, Real t)
+{
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            const Real x = (i+Real(0.5))*dx[0];
+            const Real y = (AMREX_SPACEDIM > 1) ? (j+Real(0.5))*dx[1] : Real(0.);
+            const Real z = (AMREX_SPACEDIM > 2) ? (k+Real(0.5))*dx[2] : Real(0.);
+            a(i,j,k,n) = std::sin(6*x+n+t)*std::cos(5*y-t) + z*z*(n+1) + (x > Real(0.5) ? 1 : 0);
+        });
+    }
+}
+
+// Two levels with data at two times
+struct TwoLevels
+{
+    TwoLevels (bool periodic, int ncomp)
+    {
+        const Box cdomain(IntVect(0), IntVect(31));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(periodic,periodic,periodic)};
+        cgeom.define(cdomain, rb, 0, is_per);
+        fgeom.define(amrex::refine(cdomain,ratio), rb, 0, is_per);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(8);
+        DistributionMapping cdm(cba);
+
+        // Fine boxes at, and with periodicity across, the domain boundary
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(0,16,16)), IntVect(AMREX_D_DECL(15,47,31))));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(32,16,0)), IntVect(AMREX_D_DECL(63,31,63))));
+        fba = BoxArray(std::move(fbl));
+        fba.maxSize(8);
+        DistributionMapping fdm(fba);
+
+        for (int it = 0; it < 2; ++it) {
+            crse[it].define(cba, cdm, ncomp, 0);
+            fine[it].define(fba, fdm, ncomp, 0);
+            fill(crse[it], cgeom, Real(it));
+            fill(fine[it], fgeom, Real(it));
+        }
+
+        bcs.resize(ncomp);
+        for (auto& bc : bcs) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                bc.setLo(idim, periodic ? BCType::int_dir : BCType::foextrap);
+                bc.setHi(idim, periodic ? BCType::int_dir : BCType::reflect_even);
+            }
+        }
+    }
+
+    Geometry cgeom, fgeom;
+    IntVect ratio{2};
+    BoxArray fba;
+    Array<MultiFab,2> crse, fine;
+    Vector<BCRec> bcs;
+};
+
+// The fields filled together must be the same as those filled one by one.
+int test_multi_field (bool periodic, bool same_ba)
+{
+    amrex::Print() << "Testing multi-field FillPatchTwoLevels, periodic = " << periodic
+                   << ", same BoxArray = " << same_ba << "   ";
+
+    const int ncomp = 3;
+    TwoLevels lev(periodic, ncomp);
+
+    BoxArray ba = lev.fba;
+    if (!same_ba) {
+        ba.maxSize(IntVect(AMREX_D_DECL(16,4,8)));
+    }
+    DistributionMapping dm(ba);
+
+    CpuBndryFuncFab bndry_func(nullptr);
+    PhysBCFunct<CpuBndryFuncFab> cbc(lev.cgeom, lev.bcs, bndry_func);
+    PhysBCFunct<CpuBndryFuncFab> fbc(lev.fgeom, lev.bcs, bndry_func);
+
+    const IntVect nghost(2);
+    const Real time = Real(0.3);
+    const Vector<Real> ct{Real(0.), Real(1.)};
+    const Vector<Real> ft{Real(0.), Real(1.)};
+    Vector<MultiFab*> cmf{&lev.crse[0], &lev.crse[1]};
+    Vector<MultiFab*> fmf{&lev.fine[0], &lev.fine[1]};
+
+    // Each field has its own interpolater and components.
+    struct Field {
+        InterpBase* mapper;
+        int scomp, dcomp, ncomp;
+    };
+    const Vector<Field> fields{{&cell_cons_interp, 0, 0, 3},
+                               {&mf_lincc_interp, 1, 0, 2},
+                               {&lincc_interp, 2, 1, 1}};
+
+    Vector<MultiFab> mf_all(fields.size());
+    Vector<MultiFab> mf_one(fields.size());
+    Vector<FillPatchField<MultiFab> > fpf(fields.size());
+    for (int i = 0; i < fields.size(); ++i) {
+        auto const& f = fields[i];
+        mf_all[i].define(ba, dm, f.dcomp+f.ncomp, nghost);
+        mf_one[i].define(ba, dm, f.dcomp+f.ncomp, nghost);
+        mf_all[i].setVal(-1.0);
+        mf_one[i].setVal(-1.0);
+
+        if (auto* mapper = dynamic_cast<Interpolater*>(f.mapper)) {
+            FillPatchTwoLevels(mf_one[i], nghost, time, cmf, ct, fmf, ft,
+                               f.scomp, f.dcomp, f.ncomp, lev.cgeom, lev.fgeom,
+                               cbc, f.scomp, fbc, f.scomp, lev.ratio, mapper, lev.bcs, f.scomp);
+        } else {
+            FillPatchTwoLevels(mf_one[i], nghost, time, cmf, ct, fmf, ft,
+                               f.scomp, f.dcomp, f.ncomp, lev.cgeom, lev.fgeom,
+                               cbc, f.scomp, fbc, f.scomp, lev.ratio,
+                               static_cast<MFInterpolater*>(f.mapper), lev.bcs, f.scomp);
+        }
+
+        auto& p = fpf[i];
+        p.mf = &mf_all[i];
+        p.cmf = cmf;
+        p.fmf = fmf;
+        p.scomp = f.scomp;
+        p.dcomp = f.dcomp;
+        p.ncomp = f.ncomp;
+        p.cbc = std::ref(cbc);
+        p.cbccomp = f.scomp;
+        p.fbc = std::ref(fbc);
+        p.fbccomp = f.scomp;
+        p.mapper = f.mapper;
+        p.bcs = &lev.bcs;
+        p.bcscomp = f.scomp;
+    }
+
+    FillPatchTwoLevels(fpf, nghost, time, ct, ft, lev.cgeom, lev.fgeom, lev.ratio);
+
+    // A second call, as in the next substep, must reuse the cached
+    // metadata of all the copies.
+    const Long nbuild_cpc = FabArrayBase::m_CPC_stats.nbuild;
+    const Long nbuild_fb = FabArrayBase::m_FBC_stats.nbuild;
+    const Long nbuild_fp = FabArrayBase::m_FPinfo_stats.nbuild;
+    FillPatchTwoLevels(fpf, nghost, time, ct, ft, lev.cgeom, lev.fgeom, lev.ratio);
+    const bool cached = FabArrayBase::m_CPC_stats.nbuild == nbuild_cpc &&
+                        FabArrayBase::m_FBC_stats.nbuild == nbuild_fb &&
+                        FabArrayBase::m_FPinfo_stats.nbuild == nbuild_fp;
+
+    Real maxdiff = 0.0;
+    for (int i = 0; i < fields.size(); ++i) {
+        MultiFab::Subtract(mf_all[i], mf_one[i], 0, 0, mf_all[i].nComp(), nghost);
+        maxdiff = std::max(maxdiff, mf_all[i].norminf(0, mf_all[i].nComp(), nghost));
+    }
+    if (!cached) {
+        amrex::Print() << "failed, copy metadata not cached\n";
+        return 1;
+    } else if (maxdiff == Real(0.)) {
+        amrex::Print() << "pass\n";
+        return 0;
+    } else {
+        amrex::Print() << "failed, max. difference " << maxdiff << "\n";
+        return 1;
+    }
+}
+
+// With the coarse patches of both times in a CrsePatchCache, the MF
+// interpolaters interpolate in time and space in one pass.  The results
+// must be bitwise identical to those of the separate passes.
+int test_interp_time (bool periodic, MFInterpolater* mapper, std::string const& name)
+{
+    amrex::Print() << "Testing one-pass time interpolation with " << name
+                   << ", periodic = " << periodic << "   ";
+
+    const int ncomp = 3;
+    TwoLevels lev(periodic, ncomp);
+    DistributionMapping dm(lev.fba);
+
+    CpuBndryFuncFab bndry_func(nullptr);
+    PhysBCFunct<CpuBndryFuncFab> cbc(lev.cgeom, lev.bcs, bndry_func);
+    PhysBCFunct<CpuBndryFuncFab> fbc(lev.fgeom, lev.bcs, bndry_func);
+
+    const IntVect nghost(2);
+    const Vector<Real> ct{Real(0.), Real(1.)};
+    const Vector<Real> ft{Real(0.), Real(1.)};
+    Vector<MultiFab*> cmf{&lev.crse[0], &lev.crse[1]};
+    Vector<MultiFab*> fmf{&lev.fine[0], &lev.fine[1]};
+
+    MultiFab mf_sep(lev.fba, dm, ncomp, nghost);
+    MultiFab mf_one(lev.fba, dm, ncomp, nghost);
+
+    Real maxdiff = 0.0;
+    for (Real time : {Real(0.), Real(0.3), Real(1.)}) {
+        mf_sep.setVal(-1.0);
+        mf_one.setVal(-1.0);
+        FillPatchTwoLevels(mf_sep, nghost, time, cmf, ct, fmf, ft, 0, 0, ncomp,
+                           lev.cgeom, lev.fgeom, cbc, 0, fbc, 0, lev.ratio, mapper, lev.bcs, 0);
+        {
+            CrsePatchCache cache({cmf[0], cmf[1]});
+            // The first call fills the cache, the second one uses it.
+            for (int i = 0; i < 2; ++i) {
+                FillPatchTwoLevels(mf_one, nghost, time, cmf, ct, fmf, ft, 0, 0, ncomp,
+                                   lev.cgeom, lev.fgeom, cbc, 0, fbc, 0, lev.ratio, mapper,
+                                   lev.bcs, 0);
+            }
+        }
+        MultiFab::Subtract(mf_one, mf_sep, 0, 0, ncomp, nghost);
+        maxdiff = std::max(maxdiff, mf_one.norminf(0, ncomp, nghost));
+    }
+    if (maxdiff == Real(0.)) {
+        amrex::Print() << "pass\n";
+        return 0;
+    } else {
+        amrex::Print() << "failed, max. difference " << maxdiff << "\n";
+        return 1;
+    }
+}
+
+// Average of the test function of test_weno5 over [lo,hi]
+Real cell_average (Real lo, Real hi, bool step)
+{
+    if (step) {
+        const Real a = std::max(lo, std::min(hi, Real(0.3)));
+        return (a-lo)/(hi-lo);
+    } else {
+        constexpr Real tp = 2*3.1415926535897932;
+        return (std::cos(tp*lo)-std::cos(tp*hi))/(tp*(hi-lo));
+    }
+}
+
+void fill_averages (MultiFab& mf, Geometry const& geom, bool step)
+{
+    const auto dx = geom.CellSizeArray();
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k)
+        {
+            const IntVect iv(AMREX_D_DECL(i,j,k));
+            Real v = 1.0;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                v *= cell_average(iv[idim]*dx[idim], (iv[idim]+1)*dx[idim], step);
+            }
+            a(i,j,k) = 2 + v;
+        });
+    }
+}
+
+struct WENO5Result
+{
+    Real error;    // from the exact cell averages
+    Real cons;     // of the averages of the fine cells from the coarse data
+    Real mf_diff;  // between weno5_interp and mf_weno5_interp
+    Real min, max;
+};
+
+WENO5Result weno5 (int n, int ratio, bool step)
+{
+    const Box cdomain(IntVect(0), IntVect(n-1));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+    Geometry cgeom(cdomain, rb, 0, is_per);
+    Geometry fgeom(amrex::refine(cdomain,ratio), rb, 0, is_per);
+
+    BoxArray cba(cdomain);
+    cba.maxSize(8);
+    DistributionMapping cdm(cba);
+    MultiFab crse(cba, cdm, 1, 0);
+    fill_averages(crse, cgeom, step);
+
+    BoxArray fba(Box(IntVect(n*ratio/4), IntVect(3*n*ratio/4-1)));
+    fba.maxSize(16);
+    DistributionMapping fdm(fba);
+    const IntVect nghost(2);
+    MultiFab fine(fba, fdm, 1, nghost);
+    MultiFab fine_mf(fba, fdm, 1, nghost);
+    MultiFab exact(fba, fdm, 1, nghost);
+    fill_averages(exact, fgeom, step);
+
+    Vector<BCRec> bcs(1);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        bcs[0].setLo(idim, BCType::int_dir);
+        bcs[0].setHi(idim, BCType::int_dir);
+    }
+    PhysBCFunctNoOp bndry;
+    InterpFromCoarseLevel(fine, nghost, 0.0, crse, 0, 0, 1, cgeom, fgeom,
+                          bndry, 0, bndry, 0, IntVect(ratio), &weno5_interp, bcs, 0);
+    InterpFromCoarseLevel(fine_mf, nghost, 0.0, crse, 0, 0, 1, cgeom, fgeom,
+                          bndry, 0, bndry, 0, IntVect(ratio),
+                          static_cast<MFInterpolater*>(&mf_weno5_interp), bcs, 0);
+
+    WENO5Result r;
+    r.min = fine.min(0, nghost[0]);
+    r.max = fine.max(0, nghost[0]);
+
+    MultiFab::Subtract(fine_mf, fine, 0, 0, 1, nghost);
+    r.mf_diff = fine_mf.norminf(0, 1, nghost);
+
+    MultiFab crse_avg(amrex::coarsen(fba,ratio), fdm, 1, 0);
+    amrex::average_down(fine, crse_avg, 0, 1, ratio);
+    MultiFab crse_copy(crse_avg.boxArray(), fdm, 1, 0);
+    crse_copy.ParallelCopy(crse);
+    MultiFab::Subtract(crse_avg, crse_copy, 0, 0, 1, 0);
+    r.cons = crse_avg.norminf();
+
+    MultiFab::Subtract(fine, exact, 0, 0, 1, nghost);
+    r.error = fine.norminf(0, 1, nghost);
+    return r;
+}
+
+// weno5_interp is conservative, fifth-order accurate for smooth data and
+// stays within the bounds of the coarse data at a step.
+int test_weno5 (int ratio)
+{
+    amrex::Print() << "Testing weno5_interp with ratio " << ratio << "   ";
+
+    const auto r16 = weno5(16, ratio, false);
+    const auto r32 = weno5(32, ratio, false);
+    const auto rstep = weno5(32, ratio, true);
+
+    const Real order = std::log2(r16.error/r32.error);
+    bool ok = order > Real(4.5);
+    for (auto const& r : {r16, r32, rstep}) {
+        ok = ok && r.cons < Real(1.e-13) && r.mf_diff == Real(0.);
+    }
+    ok = ok && rstep.min >= Real(2.) - Real(1.e-13) && rstep.max <= Real(3.) + Real(1.e-13);
+    if (ok) {
+        amrex::Print() << "order " << order << "   pass\n";
+        return 0;
+    } else {
+        amrex::Print() << "failed, order " << order << ", errors " << r16.error << " "
+                       << r32.error << ", conservation " << r16.cons << " " << r32.cons
+                       << " " << rstep.cons << ", step range " << rstep.min << " "
+                       << rstep.max << "\n";
+        return 1;
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nerror = 0;
+        for (bool periodic : {false, true}) {
+            for (bool same_ba : {true, false}) {
+                nerror += test_multi_field(periodic, same_ba);
+            }
+            nerror += test_interp_time(periodic, &mf_cell_cons_interp, "mf_cell_cons_interp");
+            nerror += test_interp_time(periodic, &mf_lincc_interp, "mf_lincc_interp");
+        }
+        for (int ratio : {2, 4}) {
+            nerror += test_weno5(ratio);
+        }
+
+        ParallelDescriptor::ReduceIntMax(nerror);
+        if (nerror > 0) {
+            amrex::Print() << nerror << " tests failed\n";
+            amrex::Abort();
+        } else {
+            amrex::Print() << "All tests passed\n";
+        }
+    }
+    amrex::Finalize();
+}
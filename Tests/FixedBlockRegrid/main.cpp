@@ -0,0 +1,121 @@
+#include <AMReX.H>
+#include <AMReX_AmrMesh.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+using namespace amrex;
+
+namespace {
+
+bool is_tagged (IntVect const& iv)
+{
+    const IntVect c(AMREX_D_DECL(20,24,28));
+    int r = 0;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        r += (iv[d]-c[d])*(iv[d]-c[d]);
+    }
+    unsigned h = 2166136261U;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        h = (h ^ static_cast<unsigned>(iv[d])) * 16777619U;
+    }
+    return r <= 100 || (h % 997U == 0);
+}
+
+class TagMesh
+    : public AmrMesh
+{
+public:
+    TagMesh (Geometry const& level_0_geom, AmrInfo const& amr_info)
+        : AmrMesh(level_0_geom, amr_info) {}
+
+    void ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        if (lev > 0) { return; }
+        for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+            auto const& a = tags.array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                a(i,j,k) = is_tagged(IntVect(AMREX_D_DECL(i,j,k))) ? TagBox::SET : TagBox::CLEAR;
+            });
+        }
+    }
+};
+
+// The blocks of level 1 that contain tags.
+BoxArray tagged_blocks (Box const& domain, IntVect const& ref_ratio, IntVect const& bf)
+{
+    BoxList bl;
+    const IntVect crse_bf = bf / ref_ratio;
+    for (IntVect iv = domain.smallEnd(); iv <= domain.bigEnd(); domain.next(iv)) {
+        if (is_tagged(iv)) {
+            bl.push_back(amrex::refine(amrex::refine(Box(iv,iv).coarsen(crse_bf), crse_bf),
+                                       ref_ratio));
+        }
+    }
+    BoxArray ba(std::move(bl));
+    ba.removeOverlap();
+    return ba;
+}
+
+int test (Geometry const& geom, Real eff)
+{
+    amrex::Print() << "Testing fixed_block_eff = " << eff << "   ";
+
+    AmrInfo info;
+    info.max_level = 1;
+    info.blocking_factor = {IntVect(4)};
+    info.max_grid_size = {IntVect(16)};
+    info.n_error_buf = {IntVect(0)};
+    info.fixed_block_regrid = {1};
+    info.fixed_block_eff = eff;
+
+    TagMesh mesh(geom, info);
+    mesh.MakeNewGrids(0.0);
+    AMREX_ALWAYS_ASSERT(mesh.finestLevel() == 1);
+
+    BoxArray const& ba = mesh.boxArray(1);
+    const BoxArray expected = tagged_blocks(geom.Domain(), mesh.refRatio(0),
+                                            mesh.blockingFactor(1));
+
+    bool ok = ba.isDisjoint() && ba.coarsenable(mesh.blockingFactor(1))
+        && ba.contains(expected);
+    for (int i = 0; i < ba.size(); ++i) {
+        ok = ok && ba[i].length().allLE(mesh.maxGridSize(1));
+    }
+    if (eff == Real(1.0)) {
+        // Only fully tagged regions are merged.
+        ok = ok && ba.numPts() == expected.numPts();
+    }
+    if (ok) {
+        amrex::Print() << ba.size() << " boxes   pass\n";
+        return 0;
+    } else {
+        amrex::Print() << "failed\n";
+        return 1;
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        const Box domain(IntVect(0), IntVect(63));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+
+        int nerror = 0;
+        nerror += test(geom, Real(1.0));
+        nerror += test(geom, Real(0.5));
+
+        ParallelDescriptor::ReduceIntMax(nerror);
+        if (nerror > 0) {
+            amrex::Print() << nerror << " tests failed\n";
+            amrex::Abort();
+        } else {
+            amrex::Print() << "All tests passed\n";
+        }
+    }
+    amrex::Finalize();
+}
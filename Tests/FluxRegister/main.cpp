@@ -0,0 +1,210 @@
+#include <AMReX.H>
+#include <AMReX_FluxRegister.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Print.H>
+#include <AMReX_YAFluxRegister.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+void fill (MultiFab& mf, int seed)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = std::sin(Real(0.37)*i + Real(0.71)*j + Real(1.13)*k + Real(0.5)*n + seed);
+        });
+    }
+}
+
+// Two levels with random fluxes
+struct TwoLevels
+{
+    TwoLevels ()
+    {
+        const Box cdomain(IntVect(0), IntVect(31));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,0,1)};
+        cgeom.define(cdomain, rb, 0, is_per);
+        fgeom.define(amrex::refine(cdomain,ratio), rb, 0, is_per);
+
+        cba = BoxArray(cdomain);
+        cba.maxSize(8);
+        cdm = DistributionMapping(cba);
+
+        // Fine boxes at, and with periodicity across, the domain boundary
+        BoxList fbl;
+        fbl.push_back(Box(IntVect(0), IntVect(23)));
+        fbl.push_back(Box(IntVect(AMREX_D_DECL(40,8,0)), IntVect(AMREX_D_DECL(63,31,23))));
+        fba = BoxArray(std::move(fbl));
+        fba.maxSize(8);
+        fdm = DistributionMapping(fba);
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const IntVect ixt = IntVect::TheDimensionVector(idim);
+            cflux[idim].define(amrex::convert(cba,ixt), cdm, ncomp, 0);
+            fflux[idim].define(amrex::convert(fba,ixt), fdm, ncomp, 0);
+            fill(cflux[idim], idim);
+            fill(fflux[idim], 10+idim);
+        }
+    }
+
+    Geometry cgeom, fgeom;
+    IntVect ratio{2};
+    int ncomp = 2;
+    BoxArray cba, fba;
+    DistributionMapping cdm, fdm;
+    Array<MultiFab,AMREX_SPACEDIM> cflux, fflux;
+};
+
+// Returns 1 if a and b differ or if the reflux did not change anything.
+int check (MultiFab& a, MultiFab const& b, MultiFab& orig)
+{
+    const int ncomp = a.nComp();
+    MultiFab::Subtract(orig, b, 0, 0, ncomp, 0);
+    MultiFab::Subtract(a, b, 0, 0, ncomp, 0);
+    if (orig.norminf(0, ncomp, IntVect(0)) == Real(0.) ||
+        a.norminf(0, ncomp, IntVect(0)) != Real(0.)) {
+        amrex::Print() << "failed\n";
+        return 1;
+    } else {
+        amrex::Print() << "pass\n";
+        return 0;
+    }
+}
+
+// The nonblocking FluxRegister calls must give the same result as the
+// blocking ones, with work on the coarse data between Reflux_nowait and
+// Reflux_finish.
+int test_flux_register (FluxRegister::FrOp op, bool const_volume)
+{
+    amrex::Print() << "Testing FluxRegister nowait, op = "
+                   << (op == FluxRegister::COPY ? "COPY" : "ADD")
+                   << ", constant volume = " << const_volume << "   ";
+
+    TwoLevels lev;
+    const int nc = lev.ncomp;
+
+    MultiFab volume(lev.cba, lev.cdm, 1, 0);
+    fill(volume, 20);
+    volume.plus(Real(2.), 0, 1, 0);
+
+    MultiFab s_blocking(lev.cba, lev.cdm, nc, 0);
+    MultiFab s_nowait(lev.cba, lev.cdm, nc, 0);
+    MultiFab s_orig(lev.cba, lev.cdm, nc, 0);
+    fill(s_blocking, 100);
+    fill(s_nowait, 100);
+    fill(s_orig, 100);
+    s_orig.plus(Real(1.), 0, nc, 0);
+
+    FluxRegister fr_blocking(lev.fba, lev.fdm, lev.ratio, 1, nc);
+    FluxRegister fr_nowait(lev.fba, lev.fdm, lev.ratio, 1, nc);
+    fr_blocking.setVal(Real(0.));
+    fr_nowait.setVal(Real(0.));
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        fr_blocking.CrseInit(lev.cflux[idim], idim, 0, 0, nc, Real(-1.), op);
+        fr_nowait.CrseInit_nowait(lev.cflux[idim], idim, 0, 0, nc, Real(-1.), op);
+    }
+    fr_nowait.CrseInit_finish();
+
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        fr_blocking.FineAdd(lev.fflux[idim], idim, 0, 0, nc, Real(1.));
+        fr_nowait.FineAdd(lev.fflux[idim], idim, 0, 0, nc, Real(1.));
+    }
+
+    s_blocking.plus(Real(1.), 0, nc, 0);
+    if (const_volume) {
+        fr_blocking.Reflux(s_blocking, Real(1.), 0, 0, nc, lev.cgeom);
+        fr_nowait.Reflux_nowait(s_nowait, Real(1.), 0, 0, nc, lev.cgeom);
+    } else {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            fr_blocking.Reflux(s_blocking, volume, idim, Real(1.), 0, 0, nc, lev.cgeom);
+            fr_nowait.Reflux_nowait(s_nowait, volume, idim, Real(1.), 0, 0, nc, lev.cgeom);
+        }
+    }
+    s_nowait.plus(Real(1.), 0, nc, 0);
+    fr_nowait.Reflux_finish();
+
+    return check(s_nowait, s_blocking, s_orig);
+}
+
+// The same for YAFluxRegister
+int test_ya_flux_register ()
+{
+    amrex::Print() << "Testing YAFluxRegister nowait   ";
+
+    TwoLevels lev;
+    const int nc = lev.ncomp;
+    const auto cdx = lev.cgeom.CellSizeArray();
+    const auto fdx = lev.fgeom.CellSizeArray();
+
+    MultiFab s_blocking(lev.cba, lev.cdm, nc, 0);
+    MultiFab s_nowait(lev.cba, lev.cdm, nc, 0);
+    MultiFab s_orig(lev.cba, lev.cdm, nc, 0);
+    fill(s_blocking, 100);
+    fill(s_nowait, 100);
+    fill(s_orig, 100);
+    s_orig.plus(Real(1.), 0, nc, 0);
+
+    YAFluxRegister fr_blocking(lev.fba, lev.cba, lev.fdm, lev.cdm,
+                               lev.fgeom, lev.cgeom, lev.ratio, 1, nc);
+    YAFluxRegister fr_nowait(lev.fba, lev.cba, lev.fdm, lev.cdm,
+                             lev.fgeom, lev.cgeom, lev.ratio, 1, nc);
+
+    for (auto* fr : {&fr_blocking, &fr_nowait}) {
+        fr->reset();
+        for (MFIter mfi(s_orig); mfi.isValid(); ++mfi) {
+            if (fr->CrseHasWork(mfi)) {
+                const std::array<FArrayBox const*,AMREX_SPACEDIM> flux
+                    {AMREX_D_DECL(&lev.cflux[0][mfi], &lev.cflux[1][mfi], &lev.cflux[2][mfi])};
+                fr->CrseAdd(mfi, flux, cdx.data(), Real(0.1), RunOn::Host);
+            }
+        }
+        for (MFIter mfi(lev.fflux[0]); mfi.isValid(); ++mfi) {
+            if (fr->FineHasWork(mfi)) {
+                const std::array<FArrayBox const*,AMREX_SPACEDIM> flux
+                    {AMREX_D_DECL(&lev.fflux[0][mfi], &lev.fflux[1][mfi], &lev.fflux[2][mfi])};
+                fr->FineAdd(mfi, flux, fdx.data(), Real(0.05), RunOn::Host);
+            }
+        }
+    }
+
+    s_blocking.plus(Real(1.), 0, nc, 0);
+    fr_blocking.Reflux(s_blocking);
+
+    fr_nowait.Reflux_nowait(s_nowait);
+    s_nowait.plus(Real(1.), 0, nc, 0);
+    fr_nowait.Reflux_finish();
+
+    return check(s_nowait, s_blocking, s_orig);
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nerror = 0;
+        for (auto op : {FluxRegister::COPY, FluxRegister::ADD}) {
+            for (bool const_volume : {true, false}) {
+                nerror += test_flux_register(op, const_volume);
+            }
+        }
+        nerror += test_ya_flux_register();
+
+        ParallelDescriptor::ReduceIntMax(nerror);
+        if (nerror > 0) {
+            amrex::Print() << nerror << " tests failed\n";
+            amrex::Abort();
+        } else {
+            amrex::Print() << "All tests passed\n";
+        }
+    }
+    amrex::Finalize();
+}
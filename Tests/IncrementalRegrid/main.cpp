@@ -0,0 +1,157 @@
+#include <AMReX.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParallelContext.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+Real value (int i, int j, int k)
+{
+    return Real(i) + Real(100*j) + Real(10000*k);
+}
+
+void fill (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        auto const& a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+        {
+            a(i,j,k) = value(i,j,k);
+        });
+    }
+}
+
+BoxArray old_grids ()
+{
+    BoxArray ba(Box(IntVect(0), IntVect(63)));
+    ba.maxSize(16);
+    return ba;
+}
+
+// Every third box is chopped, the others are kept.
+BoxArray new_grids (BoxArray const& ba)
+{
+    BoxList bl;
+    for (int i = 0; i < static_cast<int>(ba.size()); ++i) {
+        if (i % 3 == 0) {
+            BoxList cbl(ba[i]);
+            cbl.maxSize(8);
+            bl.join(cbl);
+        } else {
+            bl.push_back(ba[i]);
+        }
+    }
+    return BoxArray(std::move(bl));
+}
+
+// Checks that all the boxes of new_dm are owned by the processes of the
+// current ParallelContext, that all of them get boxes and that the kept
+// boxes of those processes do not move.  The result is the same on all the
+// processes.
+int check_map (BoxArray const& new_ba, DistributionMapping const& new_dm,
+               BoxArray const& ba, DistributionMapping const& dm)
+{
+    const int nprocs = ParallelContext::NProcsSub();
+    int nerror = 0;
+    Vector<Long> ncells(nprocs, 0);
+    for (int i = 0; i < static_cast<int>(new_ba.size()); ++i) {
+        const int lrank = ParallelContext::global_to_local_rank(new_dm[i]);
+        if (lrank < 0 || lrank >= nprocs) {
+            ++nerror;
+            continue;
+        }
+        ncells[lrank] += new_ba[i].numPts();
+        for (int iold = 0; iold < static_cast<int>(ba.size()); ++iold) {
+            const int old_lrank = ParallelContext::global_to_local_rank(dm[iold]);
+            if (ba[iold] == new_ba[i] && old_lrank >= 0 && old_lrank < nprocs &&
+                dm[iold] != new_dm[i]) {
+                ++nerror;
+            }
+        }
+    }
+    for (auto n : ncells) {
+        if (n == 0) { ++nerror; }
+    }
+    return nerror;
+}
+
+// Regrids with DistributionMapping::makeIncremental and RegridFabArray in
+// the current ParallelContext.
+int test_regrid ()
+{
+    const BoxArray ba = old_grids();
+    DistributionMapping dm(ba);
+    MultiFab mf(ba, dm, 1, 0);
+    fill(mf);
+
+    const BoxArray new_ba = new_grids(ba);
+    const auto new_dm = DistributionMapping::makeIncremental(new_ba, ba, dm);
+
+    int nerror = check_map(new_ba, new_dm, ba, dm);
+    if (nerror == 0) {
+        RegridFabArray(mf, new_ba, new_dm, [] (MultiFab& fill_mf) { fill(fill_mf); });
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            auto const& a = mf.const_array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), [&] (int i, int j, int k)
+            {
+                if (a(i,j,k) != value(i,j,k)) { ++nerror; }
+            });
+        }
+    }
+    return nerror;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nerror = 0;
+
+        amrex::Print() << "Testing incremental regrid   ";
+        int nerror_world = test_regrid();
+        ParallelDescriptor::ReduceIntMax(nerror_world);
+        amrex::Print() << (nerror_world > 0 ? "failed\n" : "pass\n");
+        nerror += nerror_world;
+
+        // The old grids are distributed over all the processes.
+        const BoxArray ba = old_grids();
+        const DistributionMapping dm(ba);
+
+        // A sub-communicator per process, so that, except on process 0,
+        // the local and global ranks differ and some old owners are not in
+        // the sub-communicator.
+        const int myproc = ParallelDescriptor::MyProc();
+#ifdef BL_USE_MPI
+        MPI_Comm sub_comm;
+        MPI_Comm_split(ParallelDescriptor::Communicator(), myproc, 0, &sub_comm);
+#else
+        MPI_Comm sub_comm = ParallelDescriptor::Communicator();
+#endif
+        ParallelContext::push(sub_comm, myproc, 0);
+        const BoxArray new_ba = new_grids(ba);
+        int nerror_sub = check_map(new_ba, DistributionMapping::makeIncremental(new_ba, ba, dm),
+                                   ba, dm);
+        nerror_sub += test_regrid();
+        ParallelContext::pop();
+#ifdef BL_USE_MPI
+        MPI_Comm_free(&sub_comm);
+#endif
+        ParallelDescriptor::ReduceIntMax(nerror_sub);
+        amrex::Print() << "Testing incremental regrid in sub-communicators   "
+                       << (nerror_sub > 0 ? "failed\n" : "pass\n");
+        nerror += nerror_sub;
+
+        if (nerror > 0) {
+            amrex::Print() << nerror << " tests failed\n";
+            amrex::Abort();
+        } else {
+            amrex::Print() << "All tests passed\n";
+        }
+    }
+    amrex::Finalize();
+}
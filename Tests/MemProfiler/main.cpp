@@ -0,0 +1,109 @@
+#include <AMReX.H>
+#include <AMReX_Arena.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#ifdef AMREX_MEM_PROFILING
+#include <AMReX_MemProfiler.H>
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace amrex;
+
+#ifdef AMREX_MEM_PROFILING
+namespace {
+
+// Each thread allocates blocks of nbytes*(1..nblocks), frees the odd ones
+// itself and leaves the even ones to be freed by the next thread.
+constexpr int nthreads = 4;
+constexpr int nblocks = 200;
+constexpr std::size_t nbytes = 256;
+
+Long expected_bytes (int nfreed_parity)
+{
+    Long r = 0;
+    for (int i = 0; i < nblocks; ++i) {
+        if (i % 2 != nfreed_parity) { r += Long(nbytes*(i+1)); }
+    }
+    return r;
+}
+
+}
+#endif
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv, true, MPI_COMM_WORLD, [] ()
+    {
+        ParmParse pp("amrex");
+        pp.add("memory_tracking", 1);
+        pp.add("memory_log", std::string("memlog_test"));
+    });
+#ifdef AMREX_MEM_PROFILING
+    {
+        const Long base = MemProfiler::TrackedMemInfo().current_bytes;
+
+        std::vector<std::vector<void*> > blocks(nthreads, std::vector<void*>(nblocks));
+        std::vector<std::thread> threads;
+        for (int it = 0; it < nthreads; ++it) {
+            threads.emplace_back([&blocks, it] ()
+            {
+                MemProfiler::Owner owner("TestOwner");
+                for (int i = 0; i < nblocks; ++i) {
+                    blocks[it][i] = The_Arena()->alloc(nbytes*(i+1));
+                }
+                for (int i = 1; i < nblocks; i += 2) {
+                    The_Arena()->free(blocks[it][i]);
+                }
+            });
+        }
+        for (auto& t : threads) { t.join(); }
+
+        auto info = MemProfiler::TrackedMemInfo();
+        AMREX_ALWAYS_ASSERT(info.current_bytes == base + nthreads*expected_bytes(1));
+        AMREX_ALWAYS_ASSERT(info.hwm_bytes >= info.current_bytes);
+
+        // Free the even blocks on other threads than they were allocated on.
+        threads.clear();
+        for (int it = 0; it < nthreads; ++it) {
+            threads.emplace_back([&blocks, it] ()
+            {
+                auto& b = blocks[(it+1)%nthreads];
+                for (int i = 0; i < nblocks; i += 2) {
+                    The_Arena()->free(b[i]);
+                }
+            });
+        }
+        for (auto& t : threads) { t.join(); }
+
+        info = MemProfiler::TrackedMemInfo();
+        AMREX_ALWAYS_ASSERT(info.current_bytes == base);
+        AMREX_ALWAYS_ASSERT(info.hwm_bytes >= base + nthreads*expected_bytes(1));
+
+        // Keep the peak so that the report attributes it to the owner.
+        void* p = nullptr;
+        {
+            MemProfiler::Owner owner("TestOwner");
+            p = The_Arena()->alloc(std::size_t(2)*info.hwm_bytes);
+        }
+        std::remove("memlog_test");
+        MemProfiler::Finalize();
+        The_Arena()->free(p);
+
+        if (ParallelDescriptor::IOProcessor()) {
+            std::ifstream ifs("memlog_test");
+            std::stringstream ss;
+            ss << ifs.rdbuf();
+            AMREX_ALWAYS_ASSERT(ss.str().find("TestOwner") != std::string::npos);
+        }
+        amrex::Print() << "MemProfiler test passed\n";
+    }
+#else
+    amrex::Print() << "MemProfiler test skipped without memory profiling\n";
+#endif
+    amrex::Finalize();
+}
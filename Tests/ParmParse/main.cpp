@@ -0,0 +1,93 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+namespace {
+
+void check_inputs ()
+{
+    ParmParse pp("a");
+    AMREX_ALWAYS_ASSERT(pp.contains("x") && pp.contains("n") && !pp.contains("s"));
+    AMREX_ALWAYS_ASSERT(pp.countname("x") == 2 && pp.countname("n") == 1);
+
+    // The last definition wins, and each occurrence can be queried.
+    double x = 0;
+    pp.get("x", x);
+    AMREX_ALWAYS_ASSERT(x == 2.5);
+    pp.getkth("x", 0, x);
+    AMREX_ALWAYS_ASSERT(x == 1.5);
+
+    // The same value string read as different types.
+    int n = 0;
+    double dn = 0;
+    pp.get("n", n);
+    pp.get("n", dn);
+    AMREX_ALWAYS_ASSERT(n == 3 && dn == 3.0);
+
+    std::vector<int> v;
+    pp.getarr("v", v);
+    AMREX_ALWAYS_ASSERT(pp.countval("v") == 3 && v == std::vector<int>({1,2,3}));
+
+    std::string s;
+    ParmParse("b").get("s", s);
+    AMREX_ALWAYS_ASSERT(s == "hello");
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        check_inputs();
+
+        // Additions interleaved with queries extend the index.
+        const int nentries = 1000;
+        ParmParse pp("big");
+        for (int i = 0; i < nentries; ++i) {
+            const std::string name = "p" + std::to_string(i);
+            pp.add(name.c_str(), i);
+            int v = -1;
+            pp.get(name.c_str(), v);
+            AMREX_ALWAYS_ASSERT(v == i);
+        }
+        for (int i = 0; i < nentries; ++i) {
+            int v = -1;
+            pp.get(("p" + std::to_string(i)).c_str(), v);
+            AMREX_ALWAYS_ASSERT(v == i);
+        }
+        AMREX_ALWAYS_ASSERT(!pp.contains("p1000"));
+        AMREX_ALWAYS_ASSERT(ParmParse::getEntries("big").size() == std::size_t(nentries));
+
+        // A redefinition is found as the last occurrence.
+        pp.add("p7", 70);
+        int v7 = 0;
+        pp.get("p7", v7);
+        AMREX_ALWAYS_ASSERT(v7 == 70 && pp.countname("p7") == 2);
+
+        // Removing entries invalidates the index.
+        AMREX_ALWAYS_ASSERT(pp.remove("p7") == 2);
+        AMREX_ALWAYS_ASSERT(!pp.contains("p7") && pp.countname("p7") == 0);
+        int v8 = 0;
+        pp.get("p8", v8);
+        AMREX_ALWAYS_ASSERT(v8 == 8);
+        pp.add("p7", 77);
+        pp.get("p7", v7);
+        AMREX_ALWAYS_ASSERT(v7 == 77);
+
+        // After the table is reset, the old entries must not be found.
+        ParmParse::Finalize();
+        AMREX_ALWAYS_ASSERT(!pp.contains("p8") && !ParmParse("a").contains("x"));
+        ParmParse::Initialize(0, nullptr, "inputs");
+        AMREX_ALWAYS_ASSERT(!pp.contains("p8"));
+        check_inputs();
+
+        amrex::Print() << "ParmParse test passed\n";
+    }
+    amrex::Finalize();
+}
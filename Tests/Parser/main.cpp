@@ -1,6 +1,8 @@
 #include <AMReX.H>
 #include <AMReX_Parser.H>
 #include <AMReX_IParser.H>
+#include <cmath>
+#include <limits>
 #include <map>
 
 using namespace amrex;
@@ -89,6 +91,25 @@ int test3 (std::string const& f,
             ++nfail;
         }
     }}}
+
+    // The batched evaluation must agree with the pointwise one.
+    const int npts = N*N*N;
+    Vector<Real> batch(npts);
+    Array4<Real> const a(batch.data(), Dim3{0,0,0}, Dim3{npts,1,1}, 1);
+    exe.eval(Box(IntVect(0), IntVect(AMREX_D_DECL(npts-1,0,0))), a, 0,
+             [&] (int m, int, int) { return lo[0] + (m/(N*N))*dx[0]; },
+             [&] (int m, int, int) { return lo[1] + ((m/N)%N)*dx[1]; },
+             [&] (int m, int, int) { return lo[2] + (m%N)*dx[2]; });
+    for (int m = 0; m < npts; ++m) {
+        Real result = exe(lo[0] + (m/(N*N))*dx[0], lo[1] + ((m/N)%N)*dx[1],
+                          lo[2] + (m%N)*dx[2]);
+        if (std::abs(batch[m]-result) > abstol &&
+            std::abs(batch[m]-result) > reltol*std::abs(result)) {
+            amrex::Print() << "    batch " << m << ": " << batch[m] << ", " << result << "\n";
+            ++nfail;
+        }
+    }
+
     if (nfail > 0) {
         amrex::Print() << "    failed " << nfail << " times\n";
         return 1;
@@ -147,6 +168,124 @@ int test4 (std::string const& f,
     }
 }
 
+template <typename F>
+int testd (std::string const& f, std::string const& var, F && fb,
+           Array<Real,2> const& lo, Array<Real,2> const& hi,
+           int N, Real reltol, Real abstol)
+{
+    amrex::Print() << test_number++ << ". Testing d(\"" << f << "\")/d" << var << "   ";
+
+    Parser parser(f);
+    parser.registerVariables({"x","y"});
+    Parser dparser = parser.derivative(var);
+    auto const exe = dparser.compileHost<2>();
+    max_stack_size = std::max(max_stack_size, dparser.maxStackSize());
+
+    GpuArray<Real,2> dx{(hi[0]-lo[0]) / (N-1), (hi[1]-lo[1]) / (N-1)};
+
+    int nfail = 0;
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+        Real x = lo[0] + i*dx[0];
+        Real y = lo[1] + j*dx[1];
+        Real result = exe(x,y);
+        Real benchmark = fb(x,y);
+        Real abserror = std::abs(result-benchmark);
+        Real relerror = abserror / (1.e-50 + std::max(std::abs(result),std::abs(benchmark)));
+        if (abserror > abstol && relerror > reltol) {
+            amrex::Print() << "    f'(" << x << "," << y << ") = " << result << ", "
+                           << benchmark << "\n";
+            ++nfail;
+        }
+    }}
+    if (nfail > 0) {
+        amrex::Print() << "    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "    pass\n";
+        return 0;
+    }
+}
+
+// Subexpressions that appear more than once are computed only once.  The
+// results must be the same as without that, which is turned off by assigning
+// a local variable twice.
+int testcse (std::string const& f, Array<Real,2> const& lo, Array<Real,2> const& hi,
+             int N, Real reltol)
+{
+    amrex::Print() << test_number++ << ". Testing CSE of \"" << f << "\"   ";
+
+    Parser parser(f);
+    parser.registerVariables({"x","y"});
+    auto const exe = parser.compileHost<2>();
+    max_stack_size = std::max(max_stack_size, parser.maxStackSize());
+
+    Parser parser0("nocse_ = 0; nocse_ = 1; " + f);
+    parser0.registerVariables({"x","y"});
+    auto const exe0 = parser0.compileHost<2>();
+
+    GpuArray<Real,2> dx{(hi[0]-lo[0]) / (N-1), (hi[1]-lo[1]) / (N-1)};
+
+    int nfail = 0;
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+        Real x = lo[0] + i*dx[0];
+        Real y = lo[1] + j*dx[1];
+        Real result = exe(x,y);
+        Real benchmark = exe0(x,y);
+        Real abserror = std::abs(result-benchmark);
+        if (abserror > reltol*std::abs(benchmark)) {
+            amrex::Print() << "\n    f(" << x << "," << y << ") = " << result << ", "
+                           << benchmark;
+            ++nfail;
+        }
+    }}
+    if (nfail > 0) {
+        amrex::Print() << "\n    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "    pass\n";
+        return 0;
+    }
+}
+
+// x^e must be the same as std::pow(x,e), including the sign of zero, for
+// special values of x.  If c is not empty, e is set as a constant named c.
+int testpow (std::string const& f, std::string const& c, double e)
+{
+    amrex::Print() << test_number++ << ". Testing \"" << f << "\" with special values   ";
+
+    Parser parser(f);
+    if (!c.empty()) {
+        parser.setConstant(c, e);
+    }
+    parser.registerVariables({"x"});
+    auto const exe = parser.compileHost<1>();
+
+    const double inf = std::numeric_limits<double>::infinity();
+    int nfail = 0;
+    for (double x : {-inf, -2.0, -0.0, 0.0, 0.3, 4.0, inf,
+                     std::numeric_limits<double>::quiet_NaN()}) {
+        double result = exe(x);
+        double benchmark = std::pow(x,e);
+        bool same = (std::isnan(result) && std::isnan(benchmark))
+            || (std::signbit(result) == std::signbit(benchmark)
+                && (result == benchmark
+                    || std::abs(result-benchmark) <= 1.e-15*std::abs(benchmark)));
+        if (!same) {
+            amrex::Print() << "\n    f(" << x << ") = " << result << ", " << benchmark;
+            ++nfail;
+        }
+    }
+    if (nfail > 0) {
+        amrex::Print() << "\n    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "    pass\n";
+        return 0;
+    }
+}
+
 int main (int argc, char* argv[])
 {
     amrex::Initialize(argc, argv);
@@ -356,6 +495,69 @@ int main (int argc, char* argv[])
                         {0.e-6, 0.0, -20.e-6}, {20.e-6, 1.e-10, 20.e-6}, 100,
                         1.e-12, 1.e-15);
 
+        nerror += testd("r=sqrt(x*x+y*y); exp(-r)*sin(3*x)/r + x^2.5 + atan(y/x)", "x",
+                        [=] (Real x, Real y) -> Real {
+                            Real r = std::sqrt(x*x+y*y);
+                            return -x/r*std::exp(-r)*std::sin(3*x)/r
+                                + 3*std::exp(-r)*std::cos(3*x)/r
+                                - std::exp(-r)*std::sin(3*x)*x/(r*r*r)
+                                + 2.5*std::pow(x,1.5) - y/(x*x+y*y);
+                        },
+                        {0.1, -1.0}, {2.0, 1.0}, 40,
+                        1.e-12, 1.e-14);
+
+        nerror += testd("r=sqrt(x*x+y*y); exp(-r)*sin(3*x)/r + x^2.5 + atan(y/x)", "y",
+                        [=] (Real x, Real y) -> Real {
+                            Real r = std::sqrt(x*x+y*y);
+                            return -y/r*std::exp(-r)*std::sin(3*x)/r
+                                - std::exp(-r)*std::sin(3*x)*y/(r*r*r)
+                                + x/(x*x+y*y);
+                        },
+                        {0.1, -1.0}, {2.0, 1.0}, 40,
+                        1.e-12, 1.e-14);
+
+        nerror += testd("if(x<y, log(x)*y**3, min(x*y, tanh(x)))", "x",
+                        [=] (Real x, Real y) -> Real {
+                            if (x < y) {
+                                return y*y*y/x;
+                            } else if (x*y < std::tanh(x)) {
+                                return y;
+                            } else {
+                                return 1.0/(std::cosh(x)*std::cosh(x));
+                            }
+                        },
+                        {0.1, 0.1}, {2.0, 2.0}, 40,
+                        1.e-12, 1.e-14);
+
+        nerror += testd("x^-3 + (y*x+1)^(-2) + 2*x^-1 + x^1*y + (x-y)^2 + (x+y)**3", "x",
+                        [=] (Real x, Real y) -> Real {
+                            return -3/(x*x*x*x) - 2*y/std::pow(y*x+1,3) - 2/(x*x)
+                                + y + 2*(x-y) + 3*(x+y)*(x+y);
+                        },
+                        {0.1, 0.1}, {2.0, 2.0}, 40,
+                        1.e-12, 1.e-14);
+
+        nerror += testd("(sin(x)+2)^-3 * y^-3", "y",
+                        [=] (Real x, Real y) -> Real {
+                            return -3/std::pow(std::sin(x)+2,3)/(y*y*y*y);
+                        },
+                        {0.1, 0.1}, {2.0, 2.0}, 40,
+                        1.e-12, 1.e-14);
+
+        nerror += testcse("sqrt(x*x+y*y)*exp(-sqrt(y*y+x*x)) + sin(x*y)/(1+sqrt(x*x+y*y))",
+                          {-2.0, -2.0}, {2.0, 2.0}, 40, 0.0);
+
+        nerror += testcse("a = x*y+1; b = x*y+1; if(x < y, a*(x*y+1), b/(y*x+1)) + (x-y)^2*(y-x)",
+                          {-2.0, -2.0}, {2.0, 2.0}, 40, 0.0);
+
+        nerror += testcse("(x*x+y*y)^0.5 + (x*x+y*y)^-0.5 + (x*x+y*y)^1.5 + x^0.5*y^1.5",
+                          {0.0, 0.1}, {2.0, 2.0}, 40, 1.e-15);
+
+        nerror += testpow("x^0.5", "", 0.5);
+        nerror += testpow("x^-0.5", "", -0.5);
+        nerror += testpow("x^1.5", "", 1.5);
+        nerror += testpow("x^e", "e", 0.5);
+
         amrex::Print() << "\nMax stack size is " << max_stack_size << "\n";
         if (nerror > 0) {
             amrex::Print() << nerror << " tests failed\n";
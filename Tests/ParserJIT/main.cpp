@@ -0,0 +1,110 @@
+#include <AMReX.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_Parser.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <cmath>
+#include <string>
+
+using namespace amrex;
+
+namespace {
+
+// The serial and the MPI tests run in the same directory.
+std::string cache_dir ()
+{
+    return "parser_jit_cache_" + std::to_string(ParallelDescriptor::NProcs());
+}
+
+int test (std::string const& f)
+{
+    amrex::Print() << "Testing \"" << f << "\"   ";
+
+    Parser parser(f);
+    parser.registerVariables({"x","y"});
+    auto const exe = parser.compileHost<2>();
+    if (exe.m_host_native == nullptr) {
+        amrex::Print() << "failed to compile natively\n";
+        return 1;
+    }
+
+    // The same expression is loaded once.
+    Parser parser2(f);
+    parser2.registerVariables({"x","y"});
+    AMREX_ALWAYS_ASSERT(parser2.compileHost<2>().m_host_native == exe.m_host_native);
+
+    auto byte_code = exe;
+    byte_code.m_host_native = nullptr;
+
+    const int N = 30;
+    int nfail = 0;
+    for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+        const double x = 0.1 + i*0.07;
+        const double y = 0.1 + j*0.05;
+        const double r = exe(x,y);
+        const double b = byte_code(x,y);
+        if (std::abs(r-b) > 1.e-12*std::max(std::abs(b), 1.0)) {
+            amrex::Print() << "\n    f(" << x << "," << y << ") = " << r << ", " << b;
+            ++nfail;
+        }
+    }}
+    if (nfail > 0) {
+        amrex::Print() << "\n    failed " << nfail << " times\n";
+        return 1;
+    } else {
+        amrex::Print() << "pass\n";
+        return 0;
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv, true, MPI_COMM_WORLD, [] ()
+    {
+        ParmParse pp("amrex");
+        pp.add("parser_jit", 1);
+        pp.add("parser_jit_cache", cache_dir());
+    });
+    {
+        if (ParallelDescriptor::IOProcessor()) {
+            FileSystem::RemoveAll(cache_dir());
+        }
+        ParallelDescriptor::Barrier();
+
+        int nerror = 0;
+
+        // The expression is copied into a comment of the generated code, so
+        // its own comments, line breaks and trailing backslashes must not
+        // break the code.
+        nerror += test("a = x*y;\n"
+                       "b = a + sin(x);\n"
+                       "if(x < y, a*b, b/a) + x^-3 + y**2.5 + exp(-a)/b"
+                       " // a comment with */ and a line continuation \\");
+
+        nerror += test("min(x,y) + max(x,y)*heaviside(x-y, 0.5) + jn(2, x) + fmod(x, 0.3)"
+                       " + floor(3*x) + ceil(2*y) + abs(y-x) + (x >= y) + (x != y)"
+                       " + (x < 1 and y > 0.5) + (x > 2 or y < 0.2)");
+
+        nerror += test("r2 = x*x + y*y; r = sqrt(r2); atan(y/x)*log(r) + tanh(r)*cosh(x)"
+                       " - sinh(y)/r2 + log10(r)*asin(y/(r+1)) + acos(x/(r+1))"
+                       " + r2^0.5 + x^-0.5 + y^1.5");
+
+        ParallelDescriptor::ReduceIntMax(nerror);
+        ParallelDescriptor::Barrier();
+        if (ParallelDescriptor::IOProcessor()) {
+            FileSystem::RemoveAll(cache_dir());
+        }
+
+        if (nerror > 0) {
+            amrex::Print() << nerror << " tests failed\n";
+            amrex::Abort();
+        } else {
+            amrex::Print() << "All tests passed\n";
+        }
+    }
+    amrex::Finalize();
+}
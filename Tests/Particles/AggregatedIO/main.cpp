@@ -0,0 +1,121 @@
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+
+using namespace amrex;
+
+static constexpr int NSR = 1;
+static constexpr int NSI = 1;
+static constexpr int NAR = 2;
+static constexpr int NAI = 1;
+
+using PC = ParticleContainer<NSR, NSI, NAR, NAI>;
+
+struct TestParams {
+    IntVect size;
+    int max_grid_size;
+    Long num_particles;
+};
+
+void set_attributes (PC& pc)
+{
+    for (int lev = 0; lev <= pc.finestLevel(); ++lev) {
+        for (PC::ParIterType pti(pc, lev); pti.isValid(); ++pti) {
+            auto& ptile = pti.GetParticleTile();
+            auto ptd = ptile.getParticleTileData();
+            const int np = pti.numParticles();
+            amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+            {
+                auto& p = ptd.m_aos[i];
+                p.rdata(0) = p.pos(0);
+                p.idata(0) = static_cast<int>(p.id() % 1000);
+                ptd.m_rdata[0][i] = p.pos(0) + p.pos(1);
+                ptd.m_rdata[1][i] = 1.0_prt;
+                ptd.m_idata[0][i] = static_cast<int>(p.id() % 7);
+            });
+        }
+    }
+}
+
+GpuTuple<ParticleReal,ParticleReal,ParticleReal,Long> checksums (PC const& pc)
+{
+    using PType = PC::SuperParticleType;
+    ReduceOps<ReduceOpSum,ReduceOpSum,ReduceOpSum,ReduceOpSum> reduce_ops;
+    return amrex::ParticleReduce<ReduceData<ParticleReal,ParticleReal,ParticleReal,Long> >(
+        pc, [=] AMREX_GPU_DEVICE (const PType& p) noexcept
+            -> GpuTuple<ParticleReal,ParticleReal,ParticleReal,Long>
+        {
+            return {p.rdata(0), p.rdata(NSR), p.rdata(NSR+1),
+                    Long(p.idata(0)) + Long(p.idata(NSI))};
+        }, reduce_ops);
+}
+
+void test_aggregated_io (TestParams const& parms)
+{
+    RealBox real_box;
+    for (int n = 0; n < AMREX_SPACEDIM; n++) {
+        real_box.setLo(n, 0.0);
+        real_box.setHi(n, 1.0);
+    }
+
+    const Box domain(IntVect(0), parms.size - 1);
+    Array<int,AMREX_SPACEDIM> is_per{AMREX_D_DECL(1,1,1)};
+    Geometry geom(domain, real_box, CoordSys::cartesian, is_per);
+
+    BoxArray ba(domain);
+    ba.maxSize(parms.max_grid_size);
+    DistributionMapping dm(ba);
+
+    PC pc(geom, dm, ba);
+    PC::ParticleInitData pdata = {{0.0}, {0}, {0.0, 0.0}, {0}};
+    pc.InitRandom(parms.num_particles, 451, pdata);
+    set_attributes(pc);
+
+    const Long np_old = pc.TotalNumberOfParticles();
+    auto sums_old = checksums(pc);
+
+    pc.Checkpoint("chk_aggregated", "particles");
+
+    PC pc2(geom, dm, ba);
+    pc2.Restart("chk_aggregated", "particles");
+
+    const Long np_new = pc2.TotalNumberOfParticles();
+    auto sums_new = checksums(pc2);
+
+    ParallelDescriptor::ReduceRealSum(amrex::get<0>(sums_old));
+    ParallelDescriptor::ReduceRealSum(amrex::get<1>(sums_old));
+    ParallelDescriptor::ReduceRealSum(amrex::get<2>(sums_old));
+    ParallelDescriptor::ReduceLongSum(amrex::get<3>(sums_old));
+    ParallelDescriptor::ReduceRealSum(amrex::get<0>(sums_new));
+    ParallelDescriptor::ReduceRealSum(amrex::get<1>(sums_new));
+    ParallelDescriptor::ReduceRealSum(amrex::get<2>(sums_new));
+    ParallelDescriptor::ReduceLongSum(amrex::get<3>(sums_new));
+
+    AMREX_ALWAYS_ASSERT(np_old == np_new);
+    AMREX_ALWAYS_ASSERT(amrex::get<3>(sums_old) == amrex::get<3>(sums_new));
+    const ParticleReal tol = 1.e-5_prt * static_cast<ParticleReal>(np_old);
+    AMREX_ALWAYS_ASSERT(std::abs(amrex::get<0>(sums_old) - amrex::get<0>(sums_new)) < tol);
+    AMREX_ALWAYS_ASSERT(std::abs(amrex::get<1>(sums_old) - amrex::get<1>(sums_new)) < tol);
+    AMREX_ALWAYS_ASSERT(std::abs(amrex::get<2>(sums_old) - amrex::get<2>(sums_new)) < tol);
+
+    amrex::Print() << "Restarted " << np_new << " particles from aggregated checkpoint \n";
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        ParmParse pp("aggregated_io");
+
+        TestParams parms;
+        pp.get("size", parms.size);
+        pp.get("max_grid_size", parms.max_grid_size);
+        pp.get("num_particles", parms.num_particles);
+
+        test_aggregated_io(parms);
+
+        amrex::Print() << "pass \n";
+    }
+    amrex::Finalize();
+}
@@ -212,6 +212,37 @@ void testDoubleIO(const RealDescriptor& rd_out) {
     }
 }
 
+void testChunkedRealIO(const RealDescriptor& rd_out) {
+
+    // more data than the read buffer and the conversion blocks hold
+    std::string data_file_name = "chunked_data.dat";
+    const int n = 1000;
+
+    amrex::Vector<Real> rdata_out;
+    for (int i = 0; i < n; ++i) {
+        rdata_out.push_back(static_cast<float>(amrex::Random() - 0.5));
+    }
+
+    std::ofstream ofs;
+    ofs.open(data_file_name.c_str(), std::ios::out|std::ios::binary);
+    writeRealData(rdata_out.data(), rdata_out.size(), ofs, rd_out);
+    ofs.close();
+
+    RealDescriptor::SetReadBufferSize(77);
+
+    amrex::Vector<Real> rdata_in(rdata_out.size());
+    std::ifstream ifs;
+    ifs.open(data_file_name.c_str(), std::ios::in|std::ios::binary);
+    readRealData(rdata_in.data(), rdata_in.size(), ifs, rd_out);
+    ifs.close();
+
+    RealDescriptor::SetReadBufferSize(262144);
+
+    for (int i = 0; i < n; ++i) {
+        AMREX_ALWAYS_ASSERT(rdata_in[i] == rdata_out[i]);
+    }
+}
+
 int main(int argc, char* argv[])
 {
     amrex::Initialize(argc,argv);
@@ -255,6 +286,10 @@ int main(int argc, char* argv[])
     testDoubleIO(FPC::Ieee32NormalRealDescriptor());
     testDoubleIO(FPC::Ieee64NormalRealDescriptor());
 
+    testChunkedRealIO(FPC::Native32RealDescriptor());
+    testChunkedRealIO(FPC::Ieee32NormalRealDescriptor());
+    testChunkedRealIO(FPC::Ieee64NormalRealDescriptor());
+
     amrex::Print() << "passed!" << std::endl;
 
     amrex::Finalize();
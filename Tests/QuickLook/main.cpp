@@ -0,0 +1,191 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_QuickLook.H>
+
+#include <fstream>
+#include <map>
+
+using namespace amrex;
+
+namespace {
+
+Real value (int i, int j, int k, int n)
+{
+    return Real(i) + Real(10*j) + Real(100*k) + Real(1000*n);
+}
+
+// Average of value over the fine cells of the composite cell (i,j,k)
+Real composite_value (int i, int j, int k, int n, int c)
+{
+    const Real off = Real(0.5)*Real(c-1);
+    return value(0,0,0,n) + (c*i+off) + 10*(c*j+off) + 100*(c*k+off);
+}
+
+struct Dataset
+{
+    Box box;
+    Long offset;
+};
+
+void check (std::string const& filename, int ncomp, int c,
+            Vector<int> const& slice_dir, Vector<int> const& slice_idx,
+            Vector<int> const& project_dir, Box const& qdomain)
+{
+    std::ifstream is(filename, std::ios::in | std::ios::binary);
+    AMREX_ALWAYS_ASSERT(is.good());
+
+    std::string line;
+    std::getline(is, line);
+    AMREX_ALWAYS_ASSERT(line == "QuickLook-V1");
+    Real time;
+    int step, nc;
+    is >> time >> step >> nc;
+    AMREX_ALWAYS_ASSERT(time == Real(1.5) && step == 3 && nc == ncomp);
+    for (int n = 0; n < nc; ++n) {
+        std::string name;
+        is >> name;
+        AMREX_ALWAYS_ASSERT(name == "v"+std::to_string(n));
+    }
+    int cc;
+    is >> cc;
+    AMREX_ALWAYS_ASSERT(cc == c);
+    Real lo, hi;
+    for (int i = 0; i < AMREX_SPACEDIM; ++i) { is >> lo; AMREX_ALWAYS_ASSERT(lo == Real(0.)); }
+    for (int i = 0; i < AMREX_SPACEDIM; ++i) { is >> hi; AMREX_ALWAYS_ASSERT(hi == Real(1.)); }
+    is >> std::ws;
+    std::getline(is, line); // RealDescriptor
+    std::size_t nds;
+    is >> nds;
+    std::map<std::string,Dataset> datasets;
+    for (std::size_t ids = 0; ids < nds; ++ids) {
+        std::string name;
+        Dataset ds;
+        is >> name >> ds.box >> ds.offset;
+        datasets[name] = ds;
+    }
+    is.ignore(1); // '\n'
+    const auto data_start = is.tellg();
+
+    AMREX_ALWAYS_ASSERT(nds == std::size_t(1 + slice_dir.size() + project_dir.size()));
+
+    auto read_data = [&] (Dataset const& ds) -> Vector<float>
+    {
+        Vector<float> v(ds.box.numPts()*ncomp);
+        is.seekg(data_start + std::streamoff(ds.offset));
+        is.read(reinterpret_cast<char*>(v.data()), std::streamsize(v.size()*sizeof(float)));
+        AMREX_ALWAYS_ASSERT(is.good());
+        return v;
+    };
+
+    {
+        AMREX_ALWAYS_ASSERT(datasets.count("composite") == 1);
+        auto const& ds = datasets["composite"];
+        AMREX_ALWAYS_ASSERT(ds.box == qdomain);
+        auto v = read_data(ds);
+        Long m = 0;
+        amrex::LoopOnCpu(ds.box, ncomp, [&] (int i, int j, int k, int n)
+        {
+            AMREX_ALWAYS_ASSERT(v[m++] == float(composite_value(i,j,k,n,c)));
+        });
+    }
+
+    for (int is_ = 0; is_ < slice_dir.size(); ++is_) {
+        const int d = slice_dir[is_];
+        const std::string name = "slice_"+std::to_string(d)+"_"+std::to_string(slice_idx[is_]);
+        AMREX_ALWAYS_ASSERT(datasets.count(name) == 1);
+        auto const& ds = datasets[name];
+        Box bx = qdomain;
+        bx.setRange(d, slice_idx[is_]);
+        AMREX_ALWAYS_ASSERT(ds.box == bx);
+        auto v = read_data(ds);
+        Long m = 0;
+        amrex::LoopOnCpu(ds.box, ncomp, [&] (int i, int j, int k, int n)
+        {
+            AMREX_ALWAYS_ASSERT(v[m++] == float(composite_value(i,j,k,n,c)));
+        });
+    }
+
+    for (int d : project_dir) {
+        const std::string name = "project_"+std::to_string(d);
+        AMREX_ALWAYS_ASSERT(datasets.count(name) == 1);
+        auto const& ds = datasets[name];
+        Box bx = qdomain;
+        bx.setRange(d, qdomain.smallEnd(d));
+        AMREX_ALWAYS_ASSERT(ds.box == bx);
+        auto v = read_data(ds);
+        Long m = 0;
+        amrex::LoopOnCpu(ds.box, ncomp, [&] (int i, int j, int k, int n)
+        {
+            // value is linear, so the average along d is at the middle
+            IntVect iv(AMREX_D_DECL(i,j,k));
+            Real s = 0.0;
+            for (int l = qdomain.smallEnd(d); l <= qdomain.bigEnd(d); ++l) {
+                iv[d] = l;
+                s += composite_value(AMREX_D_DECL(iv[0],iv[1],iv[2]),n,c);
+            }
+            s /= Real(qdomain.length(d));
+            AMREX_ALWAYS_ASSERT(amrex::Math::abs(v[m++] - float(s)) <= 1.e-6f*float(s));
+        });
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        const int n_cell = 32;
+        const int ncomp = 2;
+        Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+        BoxArray ba(domain);
+        ba.maxSize(8);
+        MultiFab mf(ba, DistributionMapping(ba), ncomp, 0);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            auto const& a = mf.array(mfi);
+            amrex::LoopOnCpu(mfi.validbox(), ncomp, [&] (int i, int j, int k, int n)
+            {
+                a(i,j,k,n) = value(i,j,k,n);
+            });
+        }
+        Vector<std::string> varnames{"v0", "v1"};
+
+        {
+            ParmParse pp("ql");
+            pp.add("int", 2);
+            pp.add("coarsen", 4);
+            pp.addarr("slice_dir", std::vector<int>{0});
+            pp.addarr("slice_coord", std::vector<Real>{0.6});
+            pp.addarr("project_dir", std::vector<int>{AMREX_SPACEDIM-1});
+        }
+        QuickLook ql("ql");
+        AMREX_ALWAYS_ASSERT(ql.enabled() && ql.writeNow(4) && !ql.writeNow(3));
+        const int c = ql.coarseningRatio({&mf}, {}, ncomp);
+        AMREX_ALWAYS_ASSERT(c == 4);
+        ql.write("qlk_test", {&mf}, varnames, {geom}, {}, Real(1.5), 3);
+
+        // The composite has 8^3 cells, so a budget below that doubles the ratio.
+        {
+            ParmParse pp("ql2");
+            pp.add("int", 1);
+            pp.add("coarsen", 4);
+            pp.add("max_bytes", 8*8*8*ncomp*int(sizeof(Real)) - 1);
+        }
+        QuickLook ql2("ql2");
+        const int c2 = ql2.coarseningRatio({&mf}, {}, ncomp);
+        AMREX_ALWAYS_ASSERT(c2 == 8);
+        ql2.write("qlk_test2", {&mf}, varnames, {geom}, {}, Real(1.5), 3);
+
+        if (ParallelDescriptor::IOProcessor()) {
+            const Box qdomain = amrex::coarsen(domain, c);
+            // slice coordinate 0.6 is in cell floor(0.6*8) = 4
+            check("qlk_test", ncomp, c, {0}, {4}, {AMREX_SPACEDIM-1}, qdomain);
+            check("qlk_test2", ncomp, c2, {}, {}, {}, amrex::coarsen(domain, c2));
+        }
+        amrex::Print() << "QuickLook test passed\n";
+    }
+    amrex::Finalize();
+}
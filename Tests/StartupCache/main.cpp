@@ -0,0 +1,102 @@
+#include <AMReX.H>
+#include <AMReX_AmrMesh.H>
+#include <AMReX_FileSystem.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_StartupCache.H>
+#include <AMReX_TagBox.H>
+
+using namespace amrex;
+
+namespace {
+
+// The serial and the MPI tests run in the same directory.
+std::string cache_dir ()
+{
+    return "startup_cache_test_" + std::to_string(ParallelDescriptor::NProcs());
+}
+
+// Tags the cells of level 0 in tag_box and counts the calls to ErrorEst.
+class TagMesh
+    : public AmrMesh
+{
+public:
+    explicit TagMesh (Box const& a_tag_box) : tag_box(a_tag_box) {}
+
+    void ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/) override
+    {
+        ++nerrorest;
+        if (lev == 0) {
+            tags.setVal(BoxArray(tag_box), TagBox::SET);
+        }
+    }
+
+    Box tag_box;
+    int nerrorest = 0;
+};
+
+Vector<BoxArray> make_grids (Box const& tag_box, bool expect_cached)
+{
+    TagMesh mesh(tag_box);
+    mesh.MakeNewGrids(0.0);
+    AMREX_ALWAYS_ASSERT((mesh.nerrorest == 0) == expect_cached);
+    AMREX_ALWAYS_ASSERT(mesh.finestLevel() == 1);
+    return mesh.boxArray();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv, true, MPI_COMM_WORLD, [] ()
+    {
+        ParmParse pp("amrex");
+        pp.add("startup_cache", cache_dir());
+        pp.add("startup_cache_grids", 1);
+
+        ParmParse ppa("amr");
+        ppa.addarr("n_cell", std::vector<int>(AMREX_SPACEDIM, 32));
+        ppa.add("max_level", 1);
+        ppa.add("max_grid_size", 16);
+        ppa.add("blocking_factor", 4);
+        ppa.add("n_error_buf", 0);
+
+        ParmParse ppg("geometry");
+        ppg.addarr("prob_lo", std::vector<Real>(AMREX_SPACEDIM, 0.0));
+        ppg.addarr("prob_hi", std::vector<Real>(AMREX_SPACEDIM, 1.0));
+    });
+    {
+        AMREX_ALWAYS_ASSERT(StartupCache::gridsEnabled());
+        if (ParallelDescriptor::IOProcessor()) {
+            FileSystem::RemoveAll(cache_dir());
+        }
+        ParallelDescriptor::Barrier();
+
+        const Box box_a(IntVect(4), IntVect(11));
+        const Box box_b(IntVect(16), IntVect(27));
+
+        // The first run tags and fills the cache.
+        const auto grids_a = make_grids(box_a, false);
+        AMREX_ALWAYS_ASSERT(grids_a[1].minimalBox() == amrex::refine(box_a,2));
+
+        // Without a new version, a change of the tagging code is not seen.
+        const auto grids_stale = make_grids(box_b, true);
+        AMREX_ALWAYS_ASSERT(grids_stale == grids_a);
+
+        // A new version is part of the key, so the grids are made again ...
+        StartupCache::setVersion("tag_box_b");
+        const auto grids_b = make_grids(box_b, false);
+        AMREX_ALWAYS_ASSERT(grids_b[1].minimalBox() == amrex::refine(box_b,2));
+
+        // ... and cached under it.
+        const auto grids_b2 = make_grids(box_b, true);
+        AMREX_ALWAYS_ASSERT(grids_b2 == grids_b);
+
+        ParallelDescriptor::Barrier();
+        if (ParallelDescriptor::IOProcessor()) {
+            FileSystem::RemoveAll(cache_dir());
+        }
+        amrex::Print() << "StartupCache test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,125 @@
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+
+#include <cmath>
+#include <set>
+
+using namespace amrex;
+
+namespace {
+
+// The cells buffered around tag and swept by the displacement d (in cells)
+std::set<IntVect> expected_footprint (IntVect const& tag, IntVect const& nbuf,
+                                      Array<Real,AMREX_SPACEDIM> const& d)
+{
+    Real dmax = 0.0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        dmax = std::max(dmax, std::abs(d[idim]));
+    }
+    const int nsteps = static_cast<int>(std::ceil(dmax));
+
+    std::set<IntVect> r;
+    const Box bbx(tag-nbuf, tag+nbuf);
+    for (IntVect iv = bbx.smallEnd(); iv <= bbx.bigEnd(); bbx.next(iv)) {
+        r.insert(iv);
+        for (int m = 1; m <= nsteps; ++m) {
+            IntVect ivm = iv;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                ivm[idim] += static_cast<int>(std::floor(d[idim]*Real(m)/Real(nsteps)+Real(0.5)));
+            }
+            r.insert(ivm);
+        }
+    }
+    return r;
+}
+
+// One tag at a corner of the boxes is buffered and swept with a constant
+// velocity.  The tagged cells must not depend on the boxes.
+int test_sweep (int max_grid_size, bool on_face)
+{
+    amrex::Print() << "Testing TagBoxArray::sweep, max_grid_size = " << max_grid_size
+                   << ", velocity on faces = " << on_face << "   ";
+
+    const Box domain(IntVect(0), IntVect(63));
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Geometry geom(domain, rb, 0, {AMREX_D_DECL(0,0,0)});
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+
+    // Displacements in cells, without ties in the rounding of the paths
+    const Array<Real,AMREX_SPACEDIM> d{AMREX_D_DECL(Real(3.4), Real(-1.6), Real(0.7))};
+    const Real dt = 0.5;
+    const IntVect nbuf(1);
+    const IntVect tag_iv(31);
+
+    Array<MultiFab,AMREX_SPACEDIM> vel;
+    Array<Real,AMREX_SPACEDIM> dd;
+    IntVect ngt = nbuf;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const IntVect ixt = on_face ? IntVect::TheDimensionVector(idim) : IntVect(0);
+        vel[idim].define(amrex::convert(ba,ixt), dm, 1, 0);
+        const Real v = d[idim] / (dt * geom.InvCellSize(idim));
+        vel[idim].setVal(v);
+        // The same displacement as in sweep
+        dd[idim] = v * (dt * geom.InvCellSize(idim));
+        ngt[idim] += static_cast<int>(std::ceil(std::abs(dd[idim])));
+    }
+
+    TagBoxArray tags(ba, dm, ngt);
+    tags.setVal(BoxArray(Box(tag_iv,tag_iv)), TagBox::SET);
+    tags.buffer(nbuf);
+    tags.sweep({AMREX_D_DECL(&vel[0],&vel[1],&vel[2])}, dt, geom);
+    tags.mapPeriodicRemoveDuplicates(geom);
+
+    // Each tagged cell is now in one FAB, possibly in its ghost cells.
+    const auto expected = expected_footprint(tag_iv, nbuf, dd);
+    Long nwrong = 0;
+    Long ntagged = 0;
+    for (MFIter mfi(tags); mfi.isValid(); ++mfi) {
+        auto const& a = tags.const_array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), [&] (int i, int j, int k)
+        {
+            if (a(i,j,k) != TagBox::CLEAR) {
+                ++ntagged;
+                if (expected.count(IntVect(AMREX_D_DECL(i,j,k))) == 0) { ++nwrong; }
+            }
+        });
+    }
+    ParallelDescriptor::ReduceLongSum(nwrong);
+    ParallelDescriptor::ReduceLongSum(ntagged);
+
+    if (nwrong == 0 && ntagged == static_cast<Long>(expected.size())) {
+        amrex::Print() << "pass\n";
+        return 0;
+    } else {
+        amrex::Print() << "failed, " << ntagged << " cells tagged, " << nwrong
+                       << " of them wrong, " << expected.size() << " expected\n";
+        return 1;
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int nerror = 0;
+        for (int max_grid_size : {64, 8}) {
+            for (bool on_face : {false, true}) {
+                nerror += test_sweep(max_grid_size, on_face);
+            }
+        }
+
+        if (nerror > 0) {
+            amrex::Print() << nerror << " tests failed\n";
+            amrex::Abort();
+        } else {
+            amrex::Print() << "All tests passed\n";
+        }
+    }
+    amrex::Finalize();
+}